@@ -279,6 +279,15 @@ try_compile_async "#include <net/devlink.h>"                         \
                   ""                                                 \
                   "6.17.0 <= LINUX_VERSION_CODE"
 
+try_compile_async "#include <net/devlink.h>"                                 \
+                  "{
+                    struct devlink_health_reporter_ops ops;
+                    ops.default_graceful_period = 0;
+                   }"                                                        \
+                  "ENA_HAVE_DEVLINK_HEALTH_DEFAULT_GRACEFUL_PERIOD"          \
+                  ""                                                         \
+                  "6.17.0 <= LINUX_VERSION_CODE"
+
 try_compile_async "#include <linux/ethtool.h>"          \
                   "{
                     struct ethtool_rxfh_fields rxfh;
@@ -355,3 +364,36 @@ try_compile_async "#include <linux/netdevice.h>"                  \
                   "ENA_HAVE_TXQ_TRANS_UPDATE"                     \
                   ""                                              \
                   "5.17.0 <= LINUX_VERSION_CODE"
+
+try_compile_async "#include <linux/hrtimer.h>"             \
+                  "hrtimer_setup(NULL, NULL, 0, 0);"      \
+                  "ENA_HAVE_HRTIMER_SETUP"                \
+                  ""                                      \
+                  "6.13.0 <= LINUX_VERSION_CODE"
+
+try_compile_async "#include <linux/netdevice.h>"          \
+                  "dev_set_threaded(NULL, true);"         \
+                  "ENA_HAVE_THREADED_NAPI"                \
+                  ""                                      \
+                  "5.12.0 <= LINUX_VERSION_CODE"
+
+try_compile_async "#include <linux/sched/isolation.h>"    \
+                  "housekeeping_cpumask(HK_TYPE_DOMAIN);" \
+                  "ENA_HAVE_HK_TYPE"                      \
+                  ""                                      \
+                  "5.18.0 <= LINUX_VERSION_CODE"
+
+try_compile_async "#include <linux/netdevice.h>"                    \
+                  "__netif_set_xps_queue(NULL, NULL, 0, XPS_RXQS);" \
+                  "ENA_HAVE_XPS_RXQS"                               \
+                  ""                                                \
+                  "5.12.0 <= LINUX_VERSION_CODE"
+
+try_compile_async "#include <linux/device.h>"              \
+                  "{
+                    struct device_driver drv;
+                    drv.probe_type = PROBE_PREFER_ASYNCHRONOUS;
+                  }"                                       \
+                  "ENA_HAVE_PROBE_PREFER_ASYNCHRONOUS"     \
+                  ""                                       \
+                  "4.2.0 <= LINUX_VERSION_CODE"
@@ -3,6 +3,8 @@
  * All rights reserved.
  */
 
+#include <linux/vmalloc.h>
+
 #include "ena_debug.h"
 #include "ena_netdev.h"
 #include "ena_xdp.h"
@@ -16,6 +18,7 @@
 #define ENA_DA_TX_STATS_VERSION				1
 #define ENA_DA_RX_STATS_VERSION				1
 #define ENA_DA_PHC_STATS_VERSION			1
+#define ENA_DA_FLIGHT_RECORDER_VERSION			1
 
 #define ENA_DA_DEBUG_INFO_ADMIN_TO_VERSION		1
 #define ENA_DA_DEBUG_INFO_INV_RX_VERSION		1
@@ -57,6 +60,7 @@ static struct ena_debug_area_section_header ena_debug_area_sections[] = {
 	ENA_DEBUG_AREA_SECTION_ENTRY(tx_stats, ENA_DA_TX_STATS_VERSION),
 	ENA_DEBUG_AREA_SECTION_ENTRY(rx_stats, ENA_DA_RX_STATS_VERSION),
 	ENA_DEBUG_AREA_SECTION_ENTRY(phc_stats, ENA_DA_PHC_STATS_VERSION),
+	ENA_DEBUG_AREA_SECTION_ENTRY(flight_recorder, ENA_DA_FLIGHT_RECORDER_VERSION),
 };
 
 #define ENA_DEBUG_AREA_SECTIONS_NUM	ARRAY_SIZE(ena_debug_area_sections)
@@ -81,6 +85,20 @@ struct ena_phc_stats_header {
 	bool phc_active;
 };
 
+struct ena_flight_recorder_header {
+	/* ktime_get_ns() at the time of the dump */
+	u64 timestamp;
+	u16 max_num_queues;
+	u16 num_entries;
+	u32 reserved;
+};
+
+/* Precedes each ring's entries, which are written oldest first */
+struct ena_flight_recorder_ring_header {
+	u32 num_events;
+	u32 reserved;
+};
+
 static int ena_debug_area_rx_stats_len(struct ena_adapter *adapter)
 {
 	int stats_num = ena_get_stats_array_rx_size();
@@ -110,6 +128,15 @@ static int ena_debug_area_phc_stats_len(struct ena_adapter *adapter)
 		ENA_DA_STAT_SIZE * ena_get_stats_array_ena_com_phc_size();
 }
 
+static int ena_debug_area_flight_recorder_len(struct ena_adapter *adapter)
+{
+	/* A Tx and an Rx recorder per queue */
+	return sizeof(struct ena_flight_recorder_header) +
+		adapter->max_num_io_queues * 2 *
+		(sizeof(struct ena_flight_recorder_ring_header) +
+		 ENA_FR_NUM_ENTRIES * sizeof(struct ena_fr_entry));
+}
+
 static int ena_debug_area_reset_info_len(struct ena_adapter *adapter)
 {
 	return sizeof(struct ena_reset_reason_debug_info);
@@ -188,6 +215,52 @@ static void ena_debug_area_dump_phc_stats(struct ena_adapter *adapter,
 	ena_get_phc_stats(adapter, (u64 **)data);
 }
 
+static void ena_debug_area_dump_ring_flight_recorder(struct ena_flight_recorder *fr,
+						     u8 **data)
+{
+	struct ena_flight_recorder_ring_header ring_header = {};
+	u32 entries_len = ENA_FR_NUM_ENTRIES * sizeof(struct ena_fr_entry);
+	u32 oldest = 0, count = 0, i;
+	struct ena_fr_entry *entries;
+
+	if (fr) {
+		ring_header.num_events = atomic_read(&fr->head);
+		oldest = ena_flight_recorder_oldest(fr, &count);
+	}
+
+	memcpy(*data, &ring_header, sizeof(ring_header));
+	*data += sizeof(ring_header);
+
+	entries = (struct ena_fr_entry *)*data;
+	for (i = 0; i < count; i++)
+		entries[i] = fr->entries[(oldest + i) & (ENA_FR_NUM_ENTRIES - 1)];
+
+	memset(&entries[count], 0,
+	       (ENA_FR_NUM_ENTRIES - count) * sizeof(struct ena_fr_entry));
+	*data += entries_len;
+}
+
+static void ena_debug_area_dump_flight_recorder(struct ena_adapter *adapter,
+						u8 **data)
+{
+	struct ena_flight_recorder_header fr_header = {};
+	int i;
+
+	fr_header.timestamp = ktime_get_ns();
+	fr_header.max_num_queues = adapter->max_num_io_queues;
+	fr_header.num_entries = ENA_FR_NUM_ENTRIES;
+	memcpy(*data, &fr_header, sizeof(fr_header));
+	*data += sizeof(fr_header);
+
+	for (i = 0; i < adapter->max_num_io_queues; i++)
+		ena_debug_area_dump_ring_flight_recorder(adapter->tx_ring[i].flight_recorder,
+							 data);
+
+	for (i = 0; i < adapter->max_num_io_queues; i++)
+		ena_debug_area_dump_ring_flight_recorder(adapter->rx_ring[i].flight_recorder,
+							 data);
+}
+
 static void ena_debug_area_dump_global_stats(struct ena_adapter *adapter,
 					     u8 **data)
 {
@@ -292,7 +365,7 @@ static void ena_update_last_tx_cdescs(struct ena_com_io_cq *io_cq,
 	}
 }
 
-static u16 ena_get_pending_tx_completions(struct ena_ring *tx_ring)
+u16 ena_get_pending_tx_completions(struct ena_ring *tx_ring)
 {
 	struct ena_tx_buffer *tx_buf;
 	u16 pending_tx = 0;
@@ -446,12 +519,84 @@ void ena_reset_reason_info_free(struct ena_adapter *adapter)
 	adapter->debug_area_info.reset_info = NULL;
 }
 
+static const char * const ena_fr_event_names[ENA_FR_EVENT_MAX] = {
+	[ENA_FR_EVENT_NONE] = "none",
+	[ENA_FR_EVENT_TX_DOORBELL] = "tx_doorbell",
+	[ENA_FR_EVENT_TX_COMPLETION] = "tx_completion",
+	[ENA_FR_EVENT_RX_COMPLETION] = "rx_completion",
+	[ENA_FR_EVENT_RX_REFILL] = "rx_refill",
+	[ENA_FR_EVENT_UNMASK_INTR] = "unmask_intr",
+};
+
+const char *ena_fr_event_name(u8 event)
+{
+	if (event >= ENA_FR_EVENT_MAX)
+		return "unknown";
+
+	return ena_fr_event_names[event];
+}
+
+/* ena_flight_recorder_oldest - Locate the recorded events of a ring
+ * @fr: flight recorder of the ring
+ * @count: returns the number of valid entries
+ *
+ * Returns the index of the oldest valid entry. The entries are the
+ * @count entries starting at it, wrapping around the recorder.
+ */
+u32 ena_flight_recorder_oldest(struct ena_flight_recorder *fr, u32 *count)
+{
+	u32 head = atomic_read(&fr->head);
+
+	if (head < ENA_FR_NUM_ENTRIES) {
+		*count = head;
+		return 0;
+	}
+
+	*count = ENA_FR_NUM_ENTRIES;
+
+	return head & (ENA_FR_NUM_ENTRIES - 1);
+}
+
+int ena_flight_recorder_alloc(struct ena_adapter *adapter)
+{
+	struct ena_flight_recorder *fr;
+	int i;
+
+	fr = vzalloc(adapter->max_num_io_queues * 2 * sizeof(*fr));
+	if (unlikely(!fr))
+		return -ENOMEM;
+
+	for (i = 0; i < adapter->max_num_io_queues; i++) {
+		adapter->tx_ring[i].flight_recorder = &fr[i];
+		adapter->rx_ring[i].flight_recorder =
+			&fr[adapter->max_num_io_queues + i];
+	}
+
+	adapter->debug_area_info.flight_recorders = fr;
+
+	return 0;
+}
+
+void ena_flight_recorder_free(struct ena_adapter *adapter)
+{
+	int i;
+
+	for (i = 0; i < adapter->max_num_io_queues; i++) {
+		adapter->tx_ring[i].flight_recorder = NULL;
+		adapter->rx_ring[i].flight_recorder = NULL;
+	}
+
+	vfree(adapter->debug_area_info.flight_recorders);
+	adapter->debug_area_info.flight_recorders = NULL;
+}
+
 static int (*ena_sections_data_len[])(struct ena_adapter *adapter) = {
 	ena_debug_area_reset_info_len,
 	ena_debug_area_global_stats_len,
 	ena_debug_area_tx_stats_len,
 	ena_debug_area_rx_stats_len,
 	ena_debug_area_phc_stats_len,
+	ena_debug_area_flight_recorder_len,
 };
 
 static void (*ena_sections_dump_functions[])(struct ena_adapter *adapter,
@@ -461,6 +606,7 @@ static void (*ena_sections_dump_functions[])(struct ena_adapter *adapter,
 	ena_debug_area_dump_tx_stats,
 	ena_debug_area_dump_rx_stats,
 	ena_debug_area_dump_phc_stats,
+	ena_debug_area_dump_flight_recorder,
 };
 
 u32 ena_get_debug_area_size(struct ena_adapter *adapter)
@@ -11,7 +11,64 @@
 #define ENA_DA_NUM_LAST_DESCS			10
 #define ENA_DA_NUM_LAST_REQ_IDS			1024
 
+/* Number of datapath events kept per ring by the flight recorder,
+ * must be a power of 2.
+ */
+#define ENA_FR_NUM_ENTRIES			64
+
 struct ena_adapter;
+struct ena_ring;
+
+enum ena_fr_event {
+	ENA_FR_EVENT_NONE = 0,
+	/* value: number of doorbells written on the ring so far */
+	ENA_FR_EVENT_TX_DOORBELL,
+	/* value: number of Tx packets completed in the poll */
+	ENA_FR_EVENT_TX_COMPLETION,
+	/* value: number of Rx packets received in the poll */
+	ENA_FR_EVENT_RX_COMPLETION,
+	/* value: number of Rx buffers refilled */
+	ENA_FR_EVENT_RX_REFILL,
+	/* value: 1 if the unmask recovers a lost interrupt, 0 otherwise */
+	ENA_FR_EVENT_UNMASK_INTR,
+	ENA_FR_EVENT_MAX,
+};
+
+struct ena_fr_entry {
+	/* ktime_get_ns() at the time of the event */
+	u64 timestamp;
+	u8 event;
+	u8 reserved;
+	/* Ring producer/consumer index after the event */
+	u16 ring_idx;
+	u32 value;
+};
+
+/* Per ring circular log of the most recent datapath events. It is always
+ * on, and entries are written by both the Tx path and the NAPI context,
+ * so the head is advanced atomically.
+ */
+struct ena_flight_recorder {
+	atomic_t head;
+	struct ena_fr_entry entries[ENA_FR_NUM_ENTRIES];
+};
+
+static inline void ena_fr_record(struct ena_flight_recorder *fr, u8 event,
+				 u16 ring_idx, u32 value)
+{
+	struct ena_fr_entry *entry;
+	u32 idx;
+
+	if (unlikely(!fr))
+		return;
+
+	idx = (u32)atomic_inc_return(&fr->head) - 1;
+	entry = &fr->entries[idx & (ENA_FR_NUM_ENTRIES - 1)];
+	entry->timestamp = ktime_get_ns();
+	entry->event = event;
+	entry->ring_idx = ring_idx;
+	entry->value = value;
+}
 
 struct ena_debug_info_admin_to {
 	/* Queried from ENA_REGS_INTR_MASK_OFF */
@@ -66,5 +123,10 @@ u32 ena_get_debug_area_size(struct ena_adapter *adapter);
 int ena_reset_reason_info_alloc(struct ena_adapter *adapter);
 void ena_reset_reason_info_free(struct ena_adapter *adapter);
 void ena_write_to_debug_area(struct ena_adapter *adapter);
+int ena_flight_recorder_alloc(struct ena_adapter *adapter);
+void ena_flight_recorder_free(struct ena_adapter *adapter);
+u32 ena_flight_recorder_oldest(struct ena_flight_recorder *fr, u32 *count);
+const char *ena_fr_event_name(u8 event);
+u16 ena_get_pending_tx_completions(struct ena_ring *tx_ring);
 
 #endif /* _ENA_DEBUG_H_ */
@@ -45,6 +45,45 @@ static int phc_stats_show(struct seq_file *file, void *priv)
 DEFINE_SHOW_ATTRIBUTE(phc_stats);
 
 #endif /* ENA_PHC_SUPPORT */
+static void tx_latency_show_hist(struct seq_file *file, const char *name,
+				 const u64 *hist)
+{
+	int i;
+
+	seq_printf(file, "  %-24s", name);
+	for (i = 0; i < ENA_TX_LAT_HIST_BUCKETS; i++)
+		seq_printf(file, " %llu", READ_ONCE(hist[i]));
+	seq_puts(file, "\n");
+}
+
+static int tx_latency_show(struct seq_file *file, void *priv)
+{
+	struct ena_adapter *adapter = file->private;
+	struct ena_tx_lat_sampler *sampler;
+	int i;
+
+	seq_printf(file, "sample_interval: %u\n",
+		   READ_ONCE(adapter->tx_lat_sample_interval));
+	seq_printf(file, "  %-24s <1", "buckets (usec):");
+	for (i = 1; i < ENA_TX_LAT_HIST_BUCKETS; i++)
+		seq_printf(file, " %lu", BIT(i - 1));
+	seq_puts(file, "\n");
+
+	for (i = 0; i < adapter->max_num_io_queues; i++) {
+		sampler = &adapter->tx_ring[i].lat_sampler;
+
+		seq_printf(file, "queue %d:\n", i);
+		tx_latency_show_hist(file, "xmit_to_doorbell:",
+				     sampler->driver_hist);
+		tx_latency_show_hist(file, "doorbell_to_completion:",
+				     sampler->device_hist);
+	}
+
+	return 0;
+}
+
+DEFINE_SHOW_ATTRIBUTE(tx_latency);
+
 void ena_debugfs_init(struct net_device *dev)
 {
 	struct ena_adapter *adapter = netdev_priv(dev);
@@ -59,6 +98,17 @@ void ena_debugfs_init(struct net_device *dev)
 			    adapter,
 			    &phc_stats_fops);
 #endif /* ENA_PHC_SUPPORT */
+
+	debugfs_create_u32("tx_lat_sample_interval",
+			   0600,
+			   adapter->debugfs_base,
+			   &adapter->tx_lat_sample_interval);
+
+	debugfs_create_file("tx_latency",
+			    0400,
+			    adapter->debugfs_base,
+			    adapter,
+			    &tx_latency_fops);
 }
 
 void ena_debugfs_terminate(struct net_device *dev)
@@ -10,6 +10,43 @@
 #endif /* ENA_PHC_SUPPORT */
 #ifdef ENA_DEVLINK_SUPPORT
 
+enum ena_devlink_param_id {
+	ENA_DEVLINK_PARAM_ID_BASE = DEVLINK_PARAM_GENERIC_ID_MAX,
+	ENA_DEVLINK_PARAM_ID_IRQ_POLICY,
+	ENA_DEVLINK_PARAM_ID_IRQ_CPU_LIST,
+};
+
+static int ena_devlink_irq_policy_validate(struct devlink *devlink, u32 id,
+					   union devlink_param_value val,
+					   struct netlink_ext_ack *extack)
+{
+	if (val.vu8 >= ENA_IRQ_POLICY_MAX) {
+		NL_SET_ERR_MSG_MOD(extack, "Invalid IRQ policy");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int ena_devlink_irq_cpu_list_validate(struct devlink *devlink, u32 id,
+					     union devlink_param_value val,
+					     struct netlink_ext_ack *extack)
+{
+	cpumask_var_t cpus;
+	int rc;
+
+	if (!zalloc_cpumask_var(&cpus, GFP_KERNEL))
+		return -ENOMEM;
+
+	rc = cpulist_parse(val.vstr, cpus);
+	if (rc)
+		NL_SET_ERR_MSG_MOD(extack, "Invalid CPU list");
+
+	free_cpumask_var(cpus);
+
+	return rc;
+}
+
 #if defined(ENA_PHC_SUPPORT) && defined(ENA_HAS_GENERIC_ENABLE_PHC_DEVLINK_PARAM)
 static int ena_devlink_enable_phc_validate(struct devlink *devlink, u32 id,
 					   union devlink_param_value val,
@@ -30,6 +67,18 @@ static int ena_devlink_enable_phc_validate(struct devlink *devlink, u32 id,
 
 #endif /* ENA_PHC_SUPPORT && ENA_HAS_GENERIC_ENABLE_PHC_DEVLINK_PARAM */
 static const struct devlink_param ena_devlink_params[] = {
+	DEVLINK_PARAM_DRIVER(ENA_DEVLINK_PARAM_ID_IRQ_POLICY,
+			     "irq_policy", DEVLINK_PARAM_TYPE_U8,
+			     BIT(DEVLINK_PARAM_CMODE_DRIVERINIT),
+			     NULL,
+			     NULL,
+			     ena_devlink_irq_policy_validate),
+	DEVLINK_PARAM_DRIVER(ENA_DEVLINK_PARAM_ID_IRQ_CPU_LIST,
+			     "irq_cpu_list", DEVLINK_PARAM_TYPE_STRING,
+			     BIT(DEVLINK_PARAM_CMODE_DRIVERINIT),
+			     NULL,
+			     NULL,
+			     ena_devlink_irq_cpu_list_validate),
 #if defined(ENA_PHC_SUPPORT) && defined(ENA_HAS_GENERIC_ENABLE_PHC_DEVLINK_PARAM)
 	DEVLINK_PARAM_GENERIC(ENABLE_PHC,
 			      BIT(DEVLINK_PARAM_CMODE_DRIVERINIT),
@@ -39,6 +88,28 @@ static const struct devlink_param ena_devlink_params[] = {
 #endif /* ENA_PHC_SUPPORT && ENA_HAS_GENERIC_ENABLE_PHC_DEVLINK_PARAM */
 };
 
+static void ena_devlink_irq_params_get(struct devlink *devlink)
+{
+	struct ena_adapter *adapter = ENA_DEVLINK_PRIV(devlink);
+	union devlink_param_value policy, cpu_list;
+	int err;
+
+	err = devl_param_driverinit_value_get(devlink,
+					      ENA_DEVLINK_PARAM_ID_IRQ_POLICY,
+					      &policy);
+	if (!err)
+		err = devl_param_driverinit_value_get(devlink,
+						      ENA_DEVLINK_PARAM_ID_IRQ_CPU_LIST,
+						      &cpu_list);
+	if (err) {
+		netdev_err(adapter->netdev, "Failed to query IRQ policy params\n");
+		return;
+	}
+
+	/* Keeps the current policy if the new one is invalid */
+	ena_set_irq_policy(adapter, policy.vu8, cpu_list.vstr);
+}
+
 void ena_devlink_params_get(struct devlink *devlink)
 {
 #if defined(ENA_PHC_SUPPORT) && defined(ENA_HAS_GENERIC_ENABLE_PHC_DEVLINK_PARAM)
@@ -49,13 +120,13 @@ void ena_devlink_params_get(struct devlink *devlink)
 	err = devl_param_driverinit_value_get(devlink,
 					      DEVLINK_PARAM_GENERIC_ID_ENABLE_PHC,
 					      &val);
-	if (err) {
+	if (err)
 		netdev_err(adapter->netdev, "Failed to query PHC param\n");
-		return;
-	}
+	else
+		ena_phc_enable(adapter, val.vbool);
 
-	ena_phc_enable(adapter, val.vbool);
 #endif /* ENA_PHC_SUPPORT && ENA_HAS_GENERIC_ENABLE_PHC_DEVLINK_PARAM */
+	ena_devlink_irq_params_get(devlink);
 }
 
 #if defined(ENA_PHC_SUPPORT) && defined(ENA_HAS_GENERIC_ENABLE_PHC_DEVLINK_PARAM)
@@ -126,8 +197,10 @@ static int ena_devlink_reload_up(struct devlink *devlink,
 	 * ena_fw_reset_device()). Also we're under devlink_mutex here,
 	 * so devlink isn't freed under our feet.
 	 */
-	if (!test_bit(ENA_FLAG_DEVICE_RUNNING, &adapter->flags))
+	if (!test_bit(ENA_FLAG_DEVICE_RUNNING, &adapter->flags)) {
+		ena_apply_large_llq_recommendation(adapter);
 		err = ena_restore_device(adapter);
+	}
 
 	rtnl_unlock();
 
@@ -145,12 +218,530 @@ static const struct devlink_ops ena_devlink_ops = {
 	.reload_up	= ena_devlink_reload_up,
 };
 
+static void ena_devlink_fmsg_put_ring_fr(struct devlink_fmsg *fmsg,
+					 const char *name,
+					 struct ena_flight_recorder *fr)
+{
+	struct ena_fr_entry *entry;
+	u32 oldest, count, i;
+
+	devlink_fmsg_arr_pair_nest_start(fmsg, name);
+
+	if (fr) {
+		oldest = ena_flight_recorder_oldest(fr, &count);
+		for (i = 0; i < count; i++) {
+			entry = &fr->entries[(oldest + i) & (ENA_FR_NUM_ENTRIES - 1)];
+
+			devlink_fmsg_obj_nest_start(fmsg);
+			devlink_fmsg_u64_pair_put(fmsg, "timestamp", entry->timestamp);
+			devlink_fmsg_string_pair_put(fmsg, "event",
+						     ena_fr_event_name(entry->event));
+			devlink_fmsg_u32_pair_put(fmsg, "ring_idx", entry->ring_idx);
+			devlink_fmsg_u32_pair_put(fmsg, "value", entry->value);
+			devlink_fmsg_obj_nest_end(fmsg);
+		}
+	}
+
+	devlink_fmsg_arr_pair_nest_end(fmsg);
+}
+
+static void ena_devlink_fmsg_put_fr(struct devlink_fmsg *fmsg,
+				    struct ena_adapter *adapter)
+{
+	int i;
+
+	devlink_fmsg_u64_pair_put(fmsg, "timestamp", ktime_get_ns());
+	devlink_fmsg_arr_pair_nest_start(fmsg, "queues");
+
+	for (i = 0; i < adapter->num_io_queues; i++) {
+		devlink_fmsg_obj_nest_start(fmsg);
+		devlink_fmsg_u32_pair_put(fmsg, "qid", i);
+		ena_devlink_fmsg_put_ring_fr(fmsg, "tx",
+					     adapter->tx_ring[i].flight_recorder);
+		ena_devlink_fmsg_put_ring_fr(fmsg, "rx",
+					     adapter->rx_ring[i].flight_recorder);
+		devlink_fmsg_obj_nest_end(fmsg);
+	}
+
+	devlink_fmsg_arr_pair_nest_end(fmsg);
+}
+
+static int ena_fr_reporter_dump(struct devlink_health_reporter *reporter,
+				struct devlink_fmsg *fmsg, void *priv_ctx,
+				struct netlink_ext_ack *extack)
+{
+	struct ena_adapter *adapter = devlink_health_reporter_priv(reporter);
+
+	ena_devlink_fmsg_put_fr(fmsg, adapter);
+
+	return 0;
+}
+
+static const struct devlink_health_reporter_ops ena_fr_reporter_ops = {
+	.name = "flight_recorder",
+	.dump = ena_fr_reporter_dump,
+};
+
+/* Context passed by ena_devlink_health_report() to the reporter callbacks */
+struct ena_devlink_health_ctx {
+	enum ena_regs_reset_reason_types reset_reason;
+	u16 qid;
+	bool recovered;
+};
+
+static void ena_devlink_fmsg_put_queues_state(struct devlink_fmsg *fmsg,
+					      struct ena_adapter *adapter)
+{
+	struct ena_ring *tx_ring, *rx_ring;
+	unsigned long last_intr_jiffies;
+	struct ena_napi *ena_napi;
+	int i;
+
+	devlink_fmsg_bool_pair_put(fmsg, "dev_up",
+				   test_bit(ENA_FLAG_DEV_UP, &adapter->flags));
+	devlink_fmsg_arr_pair_nest_start(fmsg, "queues");
+
+	/* Rings are only valid while the device is up */
+	if (!test_bit(ENA_FLAG_DEV_UP, &adapter->flags))
+		goto out;
+
+	for (i = 0; i < adapter->num_io_queues; i++) {
+		tx_ring = &adapter->tx_ring[i];
+		rx_ring = &adapter->rx_ring[i];
+		ena_napi = &adapter->ena_napi[i];
+		last_intr_jiffies = READ_ONCE(ena_napi->last_intr_jiffies);
+
+		devlink_fmsg_obj_nest_start(fmsg);
+		devlink_fmsg_u32_pair_put(fmsg, "qid", i);
+
+		devlink_fmsg_pair_nest_start(fmsg, "tx");
+		devlink_fmsg_obj_nest_start(fmsg);
+		devlink_fmsg_u32_pair_put(fmsg, "next_to_use", tx_ring->next_to_use);
+		devlink_fmsg_u32_pair_put(fmsg, "next_to_clean", tx_ring->next_to_clean);
+		devlink_fmsg_u32_pair_put(fmsg, "pending_completions",
+					  ena_get_pending_tx_completions(tx_ring));
+		devlink_fmsg_u32_pair_put(fmsg, "pending_submissions",
+					  ena_com_used_q_entries(tx_ring->ena_com_io_sq));
+		devlink_fmsg_u64_pair_put(fmsg, "missed_tx", tx_ring->tx_stats.missed_tx);
+		devlink_fmsg_u32_pair_put(fmsg, "msecs_since_last_napi",
+					  jiffies_to_msecs(jiffies - tx_ring->tx_stats.last_napi_jiffies));
+		devlink_fmsg_obj_nest_end(fmsg);
+		devlink_fmsg_pair_nest_end(fmsg);
+
+		devlink_fmsg_pair_nest_start(fmsg, "rx");
+		devlink_fmsg_obj_nest_start(fmsg);
+		devlink_fmsg_u32_pair_put(fmsg, "next_to_use", rx_ring->next_to_use);
+		devlink_fmsg_u32_pair_put(fmsg, "next_to_clean", rx_ring->next_to_clean);
+		devlink_fmsg_u32_pair_put(fmsg, "free_descs",
+					  ena_com_free_q_entries(rx_ring->ena_com_io_sq));
+		devlink_fmsg_obj_nest_end(fmsg);
+		devlink_fmsg_pair_nest_end(fmsg);
+
+		devlink_fmsg_pair_nest_start(fmsg, "interrupt");
+		devlink_fmsg_obj_nest_start(fmsg);
+		devlink_fmsg_bool_pair_put(fmsg, "masked", ena_napi->interrupts_masked);
+		devlink_fmsg_bool_pair_put(fmsg, "napi_scheduled",
+					   !!(ena_napi->napi.state & NAPIF_STATE_SCHED));
+		devlink_fmsg_bool_pair_put(fmsg, "first_interrupt_received",
+					   last_intr_jiffies != 0);
+		if (last_intr_jiffies)
+			devlink_fmsg_u32_pair_put(fmsg, "msecs_since_last_interrupt",
+						  jiffies_to_msecs(jiffies - last_intr_jiffies));
+		devlink_fmsg_obj_nest_end(fmsg);
+		devlink_fmsg_pair_nest_end(fmsg);
+
+		devlink_fmsg_obj_nest_end(fmsg);
+	}
+
+out:
+	devlink_fmsg_arr_pair_nest_end(fmsg);
+}
+
+static void ena_devlink_fmsg_put_keep_alive_state(struct devlink_fmsg *fmsg,
+						  struct ena_adapter *adapter)
+{
+	devlink_fmsg_bool_pair_put(fmsg, "watchdog_enabled", adapter->wd_state);
+	devlink_fmsg_bool_pair_put(fmsg, "aenq_keep_alive",
+				   ena_com_aenq_has_keep_alive(adapter->ena_dev));
+	if (adapter->keep_alive_timeout != ENA_HW_HINTS_NO_TIMEOUT)
+		devlink_fmsg_u32_pair_put(fmsg, "timeout_msecs",
+					  jiffies_to_msecs(adapter->keep_alive_timeout));
+	devlink_fmsg_u32_pair_put(fmsg, "msecs_since_last_keep_alive",
+				  jiffies_to_msecs(jiffies - READ_ONCE(adapter->last_keep_alive_jiffies)));
+}
+
+static void ena_devlink_fmsg_put_admin_state(struct devlink_fmsg *fmsg,
+					     struct ena_adapter *adapter)
+{
+	struct ena_com_admin_queue *admin_queue = &adapter->ena_dev->admin_queue;
+
+	devlink_fmsg_bool_pair_put(fmsg, "running_state",
+				   ena_com_get_admin_running_state(adapter->ena_dev));
+	devlink_fmsg_bool_pair_put(fmsg, "polling", admin_queue->polling);
+	devlink_fmsg_bool_pair_put(fmsg, "missing_interrupt",
+				   ena_com_get_missing_admin_interrupt(adapter->ena_dev));
+	devlink_fmsg_u32_pair_put(fmsg, "outstanding_cmds",
+				  atomic_read(&admin_queue->outstanding_cmds));
+	devlink_fmsg_u64_pair_put(fmsg, "submitted_cmd", admin_queue->stats.submitted_cmd);
+	devlink_fmsg_u64_pair_put(fmsg, "completed_cmd", admin_queue->stats.completed_cmd);
+	devlink_fmsg_u64_pair_put(fmsg, "aborted_cmd", admin_queue->stats.aborted_cmd);
+	devlink_fmsg_u64_pair_put(fmsg, "no_completion", admin_queue->stats.no_completion);
+}
+
+static void ena_devlink_fmsg_put_health_ctx(struct devlink_fmsg *fmsg,
+					    struct ena_devlink_health_ctx *ctx)
+{
+	/* The context is only available when the dump was triggered by a
+	 * driver report, not by a user request
+	 */
+	if (!ctx)
+		return;
+
+	devlink_fmsg_u32_pair_put(fmsg, "reset_reason", ctx->reset_reason);
+	devlink_fmsg_u32_pair_put(fmsg, "offending_qid", ctx->qid);
+}
+
+static int ena_devlink_health_recover(struct devlink_health_reporter *reporter,
+				      void *priv_ctx,
+				      struct netlink_ext_ack *extack)
+{
+	struct ena_adapter *adapter = devlink_health_reporter_priv(reporter);
+	struct ena_devlink_health_ctx *ctx = priv_ctx;
+	int rc;
+
+	if (!ctx) {
+		/* Recovery was requested by the user. The devlink instance lock
+		 * is held here, so only trigger the reset and let the reset
+		 * work perform it, as it does for the driver's own errors.
+		 */
+		ena_reset_device(adapter, ENA_REGS_RESET_USER_TRIGGER);
+		return 0;
+	}
+
+	ctx->recovered = true;
+
+	rtnl_lock();
+	rc = ena_handle_reset_trigger(adapter);
+	rtnl_unlock();
+
+	if (rc)
+		NL_SET_ERR_MSG_MOD(extack, "Device reset failed");
+
+	return rc;
+}
+
+/* The fmsg builders below must be called with rtnl lock held, so a reset
+ * can't run while the state of the reporter is being collected
+ */
+static void ena_tx_timeout_fmsg_put(struct devlink_fmsg *fmsg,
+				    struct ena_adapter *adapter)
+{
+	devlink_fmsg_u32_pair_put(fmsg, "watchdog_timeo_msecs",
+				  jiffies_to_msecs(adapter->netdev->watchdog_timeo));
+	ena_devlink_fmsg_put_queues_state(fmsg, adapter);
+}
+
+static void ena_tx_comp_fmsg_put(struct devlink_fmsg *fmsg,
+				 struct ena_adapter *adapter)
+{
+	devlink_fmsg_u32_pair_put(fmsg, "missing_tx_completion_msecs",
+				  jiffies_to_msecs(adapter->missing_tx_completion_to_jiffies));
+	devlink_fmsg_u32_pair_put(fmsg, "missing_tx_completion_threshold",
+				  adapter->missing_tx_completion_threshold);
+	ena_devlink_fmsg_put_queues_state(fmsg, adapter);
+}
+
+static void ena_keep_alive_fmsg_put(struct devlink_fmsg *fmsg,
+				    struct ena_adapter *adapter)
+{
+	ena_devlink_fmsg_put_keep_alive_state(fmsg, adapter);
+	ena_devlink_fmsg_put_queues_state(fmsg, adapter);
+}
+
+static void ena_devlink_fmsg_put_fr_section(struct devlink_fmsg *fmsg,
+					    struct ena_adapter *adapter)
+{
+	devlink_fmsg_pair_nest_start(fmsg, "flight_recorder");
+	devlink_fmsg_obj_nest_start(fmsg);
+	ena_devlink_fmsg_put_fr(fmsg, adapter);
+	devlink_fmsg_obj_nest_end(fmsg);
+	devlink_fmsg_pair_nest_end(fmsg);
+}
+
+static int ena_tx_timeout_reporter_diagnose(struct devlink_health_reporter *reporter,
+					    struct devlink_fmsg *fmsg,
+					    struct netlink_ext_ack *extack)
+{
+	struct ena_adapter *adapter = devlink_health_reporter_priv(reporter);
+
+	rtnl_lock();
+	ena_tx_timeout_fmsg_put(fmsg, adapter);
+	rtnl_unlock();
+
+	return 0;
+}
+
+static int ena_tx_timeout_reporter_dump(struct devlink_health_reporter *reporter,
+					struct devlink_fmsg *fmsg, void *priv_ctx,
+					struct netlink_ext_ack *extack)
+{
+	struct ena_adapter *adapter = devlink_health_reporter_priv(reporter);
+
+	ena_devlink_fmsg_put_health_ctx(fmsg, priv_ctx);
+
+	rtnl_lock();
+	ena_tx_timeout_fmsg_put(fmsg, adapter);
+	rtnl_unlock();
+
+	ena_devlink_fmsg_put_fr_section(fmsg, adapter);
+
+	return 0;
+}
+
+static const struct devlink_health_reporter_ops ena_tx_timeout_reporter_ops = {
+	.name = "tx_timeout",
+	.recover = ena_devlink_health_recover,
+	.diagnose = ena_tx_timeout_reporter_diagnose,
+	.dump = ena_tx_timeout_reporter_dump,
+};
+
+static int ena_tx_comp_reporter_diagnose(struct devlink_health_reporter *reporter,
+					 struct devlink_fmsg *fmsg,
+					 struct netlink_ext_ack *extack)
+{
+	struct ena_adapter *adapter = devlink_health_reporter_priv(reporter);
+
+	rtnl_lock();
+	ena_tx_comp_fmsg_put(fmsg, adapter);
+	rtnl_unlock();
+
+	return 0;
+}
+
+static int ena_tx_comp_reporter_dump(struct devlink_health_reporter *reporter,
+				     struct devlink_fmsg *fmsg, void *priv_ctx,
+				     struct netlink_ext_ack *extack)
+{
+	struct ena_adapter *adapter = devlink_health_reporter_priv(reporter);
+
+	ena_devlink_fmsg_put_health_ctx(fmsg, priv_ctx);
+
+	rtnl_lock();
+	ena_tx_comp_fmsg_put(fmsg, adapter);
+	rtnl_unlock();
+
+	ena_devlink_fmsg_put_fr_section(fmsg, adapter);
+
+	return 0;
+}
+
+static const struct devlink_health_reporter_ops ena_tx_comp_reporter_ops = {
+	.name = "tx_missing_completion",
+	.recover = ena_devlink_health_recover,
+	.diagnose = ena_tx_comp_reporter_diagnose,
+	.dump = ena_tx_comp_reporter_dump,
+};
+
+static int ena_keep_alive_reporter_diagnose(struct devlink_health_reporter *reporter,
+					    struct devlink_fmsg *fmsg,
+					    struct netlink_ext_ack *extack)
+{
+	struct ena_adapter *adapter = devlink_health_reporter_priv(reporter);
+
+	rtnl_lock();
+	ena_keep_alive_fmsg_put(fmsg, adapter);
+	rtnl_unlock();
+
+	return 0;
+}
+
+static int ena_keep_alive_reporter_dump(struct devlink_health_reporter *reporter,
+					struct devlink_fmsg *fmsg, void *priv_ctx,
+					struct netlink_ext_ack *extack)
+{
+	struct ena_adapter *adapter = devlink_health_reporter_priv(reporter);
+
+	ena_devlink_fmsg_put_health_ctx(fmsg, priv_ctx);
+
+	rtnl_lock();
+	ena_keep_alive_fmsg_put(fmsg, adapter);
+	devlink_fmsg_pair_nest_start(fmsg, "admin_queue");
+	devlink_fmsg_obj_nest_start(fmsg);
+	ena_devlink_fmsg_put_admin_state(fmsg, adapter);
+	devlink_fmsg_obj_nest_end(fmsg);
+	devlink_fmsg_pair_nest_end(fmsg);
+	rtnl_unlock();
+
+	return 0;
+}
+
+static const struct devlink_health_reporter_ops ena_keep_alive_reporter_ops = {
+	.name = "keep_alive",
+	.recover = ena_devlink_health_recover,
+	.diagnose = ena_keep_alive_reporter_diagnose,
+	.dump = ena_keep_alive_reporter_dump,
+};
+
+static int ena_admin_reporter_diagnose(struct devlink_health_reporter *reporter,
+				       struct devlink_fmsg *fmsg,
+				       struct netlink_ext_ack *extack)
+{
+	struct ena_adapter *adapter = devlink_health_reporter_priv(reporter);
+
+	rtnl_lock();
+	ena_devlink_fmsg_put_admin_state(fmsg, adapter);
+	rtnl_unlock();
+
+	return 0;
+}
+
+static int ena_admin_reporter_dump(struct devlink_health_reporter *reporter,
+				   struct devlink_fmsg *fmsg, void *priv_ctx,
+				   struct netlink_ext_ack *extack)
+{
+	struct ena_adapter *adapter = devlink_health_reporter_priv(reporter);
+
+	ena_devlink_fmsg_put_health_ctx(fmsg, priv_ctx);
+
+	rtnl_lock();
+	ena_devlink_fmsg_put_admin_state(fmsg, adapter);
+	devlink_fmsg_pair_nest_start(fmsg, "keep_alive");
+	devlink_fmsg_obj_nest_start(fmsg);
+	ena_devlink_fmsg_put_keep_alive_state(fmsg, adapter);
+	devlink_fmsg_obj_nest_end(fmsg);
+	devlink_fmsg_pair_nest_end(fmsg);
+	rtnl_unlock();
+
+	return 0;
+}
+
+static const struct devlink_health_reporter_ops ena_admin_reporter_ops = {
+	.name = "admin_timeout",
+	.recover = ena_devlink_health_recover,
+	.diagnose = ena_admin_reporter_diagnose,
+	.dump = ena_admin_reporter_dump,
+};
+
+static struct devlink_health_reporter *
+ena_devlink_health_reporter_get(struct ena_adapter *adapter,
+				enum ena_regs_reset_reason_types reset_reason,
+				const char **msg)
+{
+	switch (reset_reason) {
+	case ENA_REGS_RESET_OS_NETDEV_WD:
+	case ENA_REGS_RESET_SUSPECTED_POLL_STARVATION:
+		*msg = "Tx timeout";
+		return adapter->tx_timeout_reporter;
+	case ENA_REGS_RESET_MISS_TX_CMPL:
+	case ENA_REGS_RESET_MISS_INTERRUPT:
+	case ENA_REGS_RESET_MISS_FIRST_INTERRUPT:
+		*msg = "Missing Tx completions";
+		return adapter->tx_comp_reporter;
+	case ENA_REGS_RESET_KEEP_ALIVE_TO:
+		*msg = "Keep alive timeout";
+		return adapter->keep_alive_reporter;
+	case ENA_REGS_RESET_ADMIN_TO:
+	case ENA_REGS_RESET_MISSING_ADMIN_INTERRUPT:
+		*msg = "Admin queue timeout";
+		return adapter->admin_reporter;
+	default:
+		return NULL;
+	}
+}
+
+/* Report a pending reset to the matching devlink health reporter. Must be
+ * called from process context without rtnl lock held, since devlink may
+ * invoke the recover callback which takes it.
+ *
+ * @return: true if the reset was performed by the reporter's recover callback
+ */
+bool ena_devlink_health_report(struct ena_adapter *adapter)
+{
+	struct ena_devlink_health_ctx ctx = {};
+	struct devlink_health_reporter *reporter;
+	const char *msg;
+
+	if (!test_bit(ENA_FLAG_TRIGGER_RESET, &adapter->flags))
+		return false;
+
+	/* Make sure reset_reason is read after the reset flag, see
+	 * ena_reset_device()
+	 */
+	smp_rmb();
+
+	ctx.reset_reason = ena_get_reset_reason(adapter);
+	ctx.qid = adapter->debug_area_info.offending_qid;
+
+	reporter = ena_devlink_health_reporter_get(adapter, ctx.reset_reason, &msg);
+	if (!reporter)
+		return false;
+
+	devlink_health_report(reporter, msg, &ctx);
+
+	return ctx.recovered;
+}
+
+static struct devlink_health_reporter *
+ena_devlink_health_reporter_create(struct devlink *devlink,
+				   const struct devlink_health_reporter_ops *ops)
+{
+	struct ena_adapter *adapter = ENA_DEVLINK_PRIV(devlink);
+	struct devlink_health_reporter *reporter;
+
+#ifdef ENA_HAVE_DEVLINK_HEALTH_DEFAULT_GRACEFUL_PERIOD
+	reporter = devlink_health_reporter_create(devlink, ops, adapter);
+#else
+	reporter = devlink_health_reporter_create(devlink, ops, 0, adapter);
+#endif /* ENA_HAVE_DEVLINK_HEALTH_DEFAULT_GRACEFUL_PERIOD */
+	if (IS_ERR(reporter)) {
+		netdev_warn(adapter->netdev,
+			    "Failed to create %s devlink health reporter, rc: %ld\n",
+			    ops->name, PTR_ERR(reporter));
+		return NULL;
+	}
+
+	return reporter;
+}
+
+static void ena_devlink_health_reporters_create(struct devlink *devlink)
+{
+	struct ena_adapter *adapter = ENA_DEVLINK_PRIV(devlink);
+
+	adapter->tx_timeout_reporter =
+		ena_devlink_health_reporter_create(devlink, &ena_tx_timeout_reporter_ops);
+	adapter->tx_comp_reporter =
+		ena_devlink_health_reporter_create(devlink, &ena_tx_comp_reporter_ops);
+	adapter->keep_alive_reporter =
+		ena_devlink_health_reporter_create(devlink, &ena_keep_alive_reporter_ops);
+	adapter->admin_reporter =
+		ena_devlink_health_reporter_create(devlink, &ena_admin_reporter_ops);
+	adapter->fr_reporter =
+		ena_devlink_health_reporter_create(devlink, &ena_fr_reporter_ops);
+}
+
+static void ena_devlink_health_reporter_destroy(struct devlink_health_reporter **reporter)
+{
+	if (*reporter) {
+		devlink_health_reporter_destroy(*reporter);
+		*reporter = NULL;
+	}
+}
+
+static void ena_devlink_health_reporters_destroy(struct devlink *devlink)
+{
+	struct ena_adapter *adapter = ENA_DEVLINK_PRIV(devlink);
+
+	ena_devlink_health_reporter_destroy(&adapter->fr_reporter);
+	ena_devlink_health_reporter_destroy(&adapter->admin_reporter);
+	ena_devlink_health_reporter_destroy(&adapter->keep_alive_reporter);
+	ena_devlink_health_reporter_destroy(&adapter->tx_comp_reporter);
+	ena_devlink_health_reporter_destroy(&adapter->tx_timeout_reporter);
+}
+
 static int ena_devlink_configure_params(struct devlink *devlink)
 {
 	struct ena_adapter *adapter = ENA_DEVLINK_PRIV(devlink);
-#if defined(ENA_PHC_SUPPORT) && defined(ENA_HAS_GENERIC_ENABLE_PHC_DEVLINK_PARAM)
 	union devlink_param_value value;
-#endif /* ENA_PHC_SUPPORT && ENA_HAS_GENERIC_ENABLE_PHC_DEVLINK_PARAM */
 	int rc;
 
 	rc = devlink_params_register(devlink, ena_devlink_params,
@@ -160,6 +751,20 @@ static int ena_devlink_configure_params(struct devlink *devlink)
 		return rc;
 	}
 
+	devl_lock(devlink);
+	value.vu8 = adapter->irq_policy;
+	devl_param_driverinit_value_set(devlink,
+					ENA_DEVLINK_PARAM_ID_IRQ_POLICY,
+					value);
+	/* A list which doesn't fit is left empty, keeping the configured one */
+	if (snprintf(value.vstr, sizeof(value.vstr), "%*pbl",
+		     cpumask_pr_args(&adapter->irq_cpu_list)) >= sizeof(value.vstr))
+		value.vstr[0] = '\0';
+	devl_param_driverinit_value_set(devlink,
+					ENA_DEVLINK_PARAM_ID_IRQ_CPU_LIST,
+					value);
+	devl_unlock(devlink);
+
 #if defined(ENA_PHC_SUPPORT) && defined(ENA_HAS_GENERIC_ENABLE_PHC_DEVLINK_PARAM)
 	devl_lock(devlink);
 	value.vbool = ena_phc_is_enabled(adapter);
@@ -192,6 +797,8 @@ struct devlink *ena_devlink_alloc(struct ena_adapter *adapter)
 	if (ena_devlink_configure_params(devlink))
 		goto free_devlink;
 
+	ena_devlink_health_reporters_create(devlink);
+
 	return devlink;
 
 free_devlink:
@@ -207,6 +814,8 @@ static void ena_devlink_configure_params_clean(struct devlink *devlink)
 
 void ena_devlink_free(struct devlink *devlink)
 {
+	ena_devlink_health_reporters_destroy(devlink);
+
 	ena_devlink_configure_params_clean(devlink);
 
 	devlink_free(devlink);
@@ -22,6 +22,7 @@ void ena_devlink_params_get(struct devlink *devlink);
 #ifdef ENA_PHC_SUPPORT
 void ena_devlink_disable_phc_param(struct devlink *devlink);
 #endif /* ENA_PHC_SUPPORT */
+bool ena_devlink_health_report(struct ena_adapter *adapter);
 #else /* ENA_DEVLINK_SUPPORT */
 
 #ifndef ENA_HAS_DEVLINK_HEADERS
@@ -40,6 +41,10 @@ static inline void ena_devlink_params_get(struct devlink *devlink) {}
 #ifdef ENA_PHC_SUPPORT
 static inline void ena_devlink_disable_phc_param(struct devlink *devlink) {}
 #endif /* ENA_PHC_SUPPORT */
+static inline bool ena_devlink_health_report(struct ena_adapter *adapter)
+{
+	return false;
+}
 #endif /* ENA_DEVLINK_SUPPORT */
 
 #endif /* DEVLINK_H */
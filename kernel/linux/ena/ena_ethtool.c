@@ -150,6 +150,16 @@ static const struct ena_stats ena_accum_stats_tx_strings[] = {
 	ENA_STAT_TX_ENTRY(llq_buffer_copy),
 	ENA_STAT_TX_ENTRY(missed_tx),
 	ENA_STAT_TX_ENTRY_ATOMIC(pending_timedout_pkts),
+	ENA_STAT_TX_ENTRY(xmit_reap),
+	ENA_STAT_TX_ENTRY(doorbells_deferred),
+	ENA_STAT_TX_ENTRY(udp_gso),
+	ENA_STAT_TX_ENTRY(hdr_len_64),
+	ENA_STAT_TX_ENTRY(hdr_len_96),
+	ENA_STAT_TX_ENTRY(hdr_len_128),
+	ENA_STAT_TX_ENTRY(hdr_len_160),
+	ENA_STAT_TX_ENTRY(hdr_len_224),
+	ENA_STAT_TX_ENTRY(hdr_len_above_224),
+	ENA_STAT_TX_ENTRY(hdr_len_above_llq),
 #ifdef ENA_AF_XDP_SUPPORT
 	ENA_STAT_TX_ENTRY(xsk_cnt),
 	ENA_STAT_TX_ENTRY(xsk_bytes),
@@ -168,6 +178,7 @@ static const struct ena_stats ena_per_q_stats_tx_strings[] = {
 	ENA_STAT_TX_ENTRY(doorbells),
 	ENA_STAT_TX_ENTRY(unmask_interrupt),
 	ENA_STAT_TX_ENTRY(lost_interrupt),
+	ENA_STAT_TX_ENTRY(metadata_bytes),
 };
 
 static const struct ena_stats ena_stats_rx_strings[] = {
@@ -192,6 +203,7 @@ static const struct ena_stats ena_stats_rx_strings[] = {
 	ENA_STAT_RX_ENTRY(bad_req_id),
 	ENA_STAT_RX_ENTRY(empty_rx_ring),
 	ENA_STAT_RX_ENTRY(csum_unchecked),
+	ENA_STAT_RX_ENTRY(metadata_bytes),
 #ifdef ENA_XDP_SUPPORT
 	ENA_STAT_RX_ENTRY(xdp_aborted),
 	ENA_STAT_RX_ENTRY(xdp_drop),
@@ -1995,6 +2007,16 @@ static int ena_set_priv_flags(struct net_device *netdev, u32 priv_flags)
 }
 #endif /* ENA_LPC_SUPPORT */
 
+/* Called with rtnl lock held before every ethtool operation. Makes sure the
+ * stats buffers which are deferred from probe are initialized.
+ */
+static int ena_ethtool_begin(struct net_device *netdev)
+{
+	ena_complete_deferred_init(netdev_priv(netdev));
+
+	return 0;
+}
+
 static const struct ethtool_ops ena_ethtool_ops = {
 #ifdef ENA_HAVE_ETHTOOL_OPS_SUPPORTED_COALESCE_PARAMS
 	.supported_coalesce_params = ETHTOOL_COALESCE_USECS |
@@ -2009,6 +2031,7 @@ static const struct ethtool_ops ena_ethtool_ops = {
 #else
 	.get_settings		= ena_get_settings,
 #endif
+	.begin			= ena_ethtool_begin,
 	.get_drvinfo		= ena_get_drvinfo,
 	.get_msglevel		= ena_get_msglevel,
 	.set_msglevel		= ena_set_msglevel,
@@ -16,6 +16,11 @@
 #include <linux/moduleparam.h>
 #include <linux/numa.h>
 #include <linux/pci.h>
+#ifdef ENA_HAVE_HK_TYPE
+#include <linux/sched/isolation.h>
+#endif /* ENA_HAVE_HK_TYPE */
+#include <linux/topology.h>
+#include <linux/udp.h>
 #include <linux/utsname.h>
 #include <linux/version.h>
 #include <linux/vmalloc.h>
@@ -46,6 +51,9 @@
 
 #include "ena_debug.h"
 
+#define CREATE_TRACE_POINTS
+#include "ena_trace.h"
+
 static char driver_info[] = DEVICE_NAME " v" DRV_MODULE_GENERATION "\n";
 
 MODULE_AUTHOR("Amazon.com, Inc. or its affiliates");
@@ -80,6 +88,10 @@ static int force_large_llq_header = FORCE_LARGE_LLQ_HEADER_UNINIT_VALUE;
 module_param(force_large_llq_header, int, 0444);
 MODULE_PARM_DESC(force_large_llq_header, "Increases maximum supported header size in LLQ mode to 224 bytes, while reducing the maximum TX queue size by half.\n");
 
+static int large_llq_auto = 0;
+module_param(large_llq_auto, int, 0444);
+MODULE_PARM_DESC(large_llq_auto, "Choose the LLQ header size on devlink reload according to the observed Tx headers length. Ignored if force_large_llq_header is set\n");
+
 static int num_io_queues = ENA_MAX_NUM_IO_QUEUES;
 module_param(num_io_queues, int, 0444);
 MODULE_PARM_DESC(num_io_queues, "Sets number of RX/TX queues to allocate to device. The maximum value depends on the device and number of online CPUs.\n");
@@ -92,6 +104,34 @@ static int enable_frag_bypass = 0;
 module_param(enable_frag_bypass, int, 0444);
 MODULE_PARM_DESC(enable_frag_bypass, "Enable fragment bypass.\n");
 
+static int tx_reap_budget = 0;
+module_param(tx_reap_budget, uint, 0444);
+MODULE_PARM_DESC(tx_reap_budget, "Max Tx completions cleaned by the transmit path when the Tx queue runs low on space. 0 - disabled (default)\n");
+
+static int tx_db_coalesce_pkts = 0;
+module_param(tx_db_coalesce_pkts, uint, 0444);
+MODULE_PARM_DESC(tx_db_coalesce_pkts, "Max Tx packets whose doorbell is deferred. 0 - disabled (default)\n");
+
+static int tx_db_coalesce_usecs = 20;
+module_param(tx_db_coalesce_usecs, uint, 0444);
+MODULE_PARM_DESC(tx_db_coalesce_usecs, "Max time in usec a deferred Tx doorbell is delayed (default = 20)\n");
+
+static char *poll_mode_queues;
+module_param(poll_mode_queues, charp, 0444);
+MODULE_PARM_DESC(poll_mode_queues, "List of IO queues (e.g. 0-3) which are polled continuously with their interrupts masked\n");
+
+static int poll_idle_backoff_us = 0;
+module_param(poll_idle_backoff_us, uint, 0444);
+MODULE_PARM_DESC(poll_idle_backoff_us, "Time in usec to wait before polling an idle poll mode queue again. 0 - keep polling (default)\n");
+
+static int irq_policy = ENA_IRQ_POLICY_LOCAL;
+module_param(irq_policy, uint, 0444);
+MODULE_PARM_DESC(irq_policy, "IO IRQ placement policy. 0 - spread over the device's NUMA node (default), 1 - one queue per physical core, 2 - housekeeping CPUs only, 3 - CPUs in irq_cpu_list\n");
+
+static char *irq_cpu_list;
+module_param(irq_cpu_list, charp, 0444);
+MODULE_PARM_DESC(irq_cpu_list, "CPU list (e.g. 0-7,16) IO IRQs are placed on when irq_policy is 3\n");
+
 #ifdef ENA_LPC_SUPPORT
 static int lpc_size = ENA_LPC_MULTIPLIER_NOT_CONFIGURED;
 module_param(lpc_size, int, 0444);
@@ -103,6 +143,10 @@ static int phc_enable = 0;
 module_param(phc_enable, uint, 0444);
 MODULE_PARM_DESC(phc_enable, "Enable PHC.\n");
 
+static int phc_cache_ms = 0;
+module_param(phc_cache_ms, uint, 0444);
+MODULE_PARM_DESC(phc_cache_ms, "Serve PHC reads from a device sample refreshed every phc_cache_ms milliseconds. 0 - disabled. Min: 10, Max: 1000\n");
+
 #endif /* ENA_PHC_SUPPORT */
 static struct ena_aenq_handlers aenq_handlers;
 
@@ -267,6 +311,11 @@ int ena_xmit_common(struct ena_adapter *adapter,
 	tx_info->total_tx_size = bytes;
 	tx_info->tx_sent_jiffies = jiffies;
 	tx_info->timed_out = false;
+	ena_tx_pending_sent(ring, tx_info->tx_sent_jiffies);
+
+	trace_ena_xmit(ring->netdev->ifindex, ring->qid, ena_tx_ctx->req_id,
+		       bytes, nb_hw_desc);
+	ena_tx_lat_sample_xmit(ring, ena_tx_ctx->req_id);
 
 	ring->next_to_use = ENA_TX_RING_IDX_NEXT(next_to_use, ring_size);
 	return 0;
@@ -343,6 +392,13 @@ void ena_init_io_rings(struct ena_adapter *adapter, int count)
 		txr->tx_mem_queue_type = ena_dev->tx_mem_queue_type;
 		txr->sgl_size = adapter->max_tx_sgl_size;
 		txr->enable_bql = enable_bql;
+		txr->xmit_reap_budget = min_t(u32, tx_reap_budget,
+					      txr->ring_size / ENA_TX_POLL_BUDGET_DIVIDER);
+		spin_lock_init(&txr->tx_clean_lock);
+		txr->tx_db_coalesce_pkts = min_t(u32, tx_db_coalesce_pkts,
+						 txr->ring_size / ENA_TX_POLL_BUDGET_DIVIDER);
+		txr->tx_db_coalesce_ns = min_t(u32, tx_db_coalesce_usecs,
+					       ENA_TX_DB_COALESCE_MAX_USECS) * NSEC_PER_USEC;
 		tx_interval =
 			ena_com_get_nonadaptive_moderation_interval_tx(ena_dev);
 		WRITE_ONCE(txr->prev_interrupt_interval, tx_interval);
@@ -366,6 +422,25 @@ void ena_init_io_rings(struct ena_adapter *adapter, int count)
 	}
 }
 
+/* ena_tx_ring_metadata_size - Size of the host memory holding a Tx ring's
+ * per-descriptor software state
+ * @tx_ring: Tx ring
+ */
+static u64 ena_tx_ring_metadata_size(struct ena_ring *tx_ring)
+{
+	return (u64)tx_ring->ring_size * (sizeof(struct ena_tx_buffer) + sizeof(u16)) +
+	       tx_ring->tx_max_header_size;
+}
+
+/* ena_rx_ring_metadata_size - Size of the host memory holding an Rx ring's
+ * per-descriptor software state
+ * @rx_ring: Rx ring
+ */
+static u64 ena_rx_ring_metadata_size(struct ena_ring *rx_ring)
+{
+	return (u64)rx_ring->ring_size * (sizeof(struct ena_rx_buffer) + sizeof(u16));
+}
+
 /* ena_setup_tx_resources - allocate I/O Tx resources (Descriptors)
  * @adapter: network interface device structure
  * @qid: queue index
@@ -418,8 +493,15 @@ static int ena_setup_tx_resources(struct ena_adapter *adapter, int qid)
 	 * up fresh TX resources and there can't be any timed-out packets yet
 	 */
 	atomic64_set(&tx_ring->tx_stats.pending_timedout_pkts, 0);
+	memset(&tx_ring->pending_tracker, 0, sizeof(tx_ring->pending_tracker));
+	tx_ring->lat_sampler.state = ENA_TX_LAT_SAMPLE_IDLE;
+	tx_ring->lat_sampler.pkts_since_sample = 0;
+	ena_set_stat(&tx_ring->tx_stats.metadata_bytes,
+		     ena_tx_ring_metadata_size(tx_ring), &tx_ring->syncp);
 	tx_ring->next_to_use = 0;
 	tx_ring->next_to_clean = 0;
+	tx_ring->tx_db_pending_pkts = 0;
+	tx_ring->tx_db_pending_bytes = 0;
 	return 0;
 
 err_push_buf_intermediate_buf:
@@ -448,6 +530,8 @@ static void ena_free_tx_resources(struct ena_adapter *adapter, int qid)
 	vfree(tx_ring->free_ids);
 	tx_ring->free_ids = NULL;
 
+	ena_set_stat(&tx_ring->tx_stats.metadata_bytes, 0, &tx_ring->syncp);
+
 	vfree(tx_ring->push_buf_intermediate_buf);
 	tx_ring->push_buf_intermediate_buf = NULL;
 }
@@ -539,6 +623,8 @@ static int ena_setup_rx_resources(struct ena_adapter *adapter,
 	rx_ring->next_to_use = 0;
 	rx_ring->cpu = ena_irq->cpu;
 	rx_ring->numa_node = node;
+	ena_set_stat(&rx_ring->rx_stats.metadata_bytes,
+		     ena_rx_ring_metadata_size(rx_ring), &rx_ring->syncp);
 
 	return 0;
 }
@@ -564,6 +650,8 @@ static void ena_free_rx_resources(struct ena_adapter *adapter,
 
 	vfree(rx_ring->free_ids);
 	rx_ring->free_ids = NULL;
+
+	ena_set_stat(&rx_ring->rx_stats.metadata_bytes, 0, &rx_ring->syncp);
 }
 
 /* ena_setup_all_rx_resources - allocate I/O Rx queues resources for all queues
@@ -826,6 +914,10 @@ ring_doorbell:
 
 	rx_ring->next_to_use = next_to_use;
 
+	ena_fr_record(rx_ring->flight_recorder, ENA_FR_EVENT_RX_REFILL,
+		      next_to_use, i);
+	trace_ena_refill_rx_bufs(rx_ring->netdev->ifindex, rx_ring->qid, num, i);
+
 	return i;
 }
 
@@ -1080,7 +1172,12 @@ int validate_tx_req_id(struct ena_ring *tx_ring, u16 req_id)
 	return handle_invalid_req_id(tx_ring, req_id, tx_info);
 }
 
-static int ena_clean_tx_irq(struct ena_ring *tx_ring, u32 budget)
+/* ena_clean_tx_irq - clean Tx completions
+ * @tx_ring: Tx ring
+ * @budget: max number of completed packets to clean
+ * @in_napi: false when called from ena_start_xmit() with the Tx queue lock held
+ */
+static int ena_clean_tx_irq(struct ena_ring *tx_ring, u32 budget, bool in_napi)
 {
 	struct skb_shared_hwtstamps tx_hw_timestamp = {};
 	int rc, tx_pkts = 0, missed_tx = 0;
@@ -1113,6 +1210,8 @@ static int ena_clean_tx_irq(struct ena_ring *tx_ring, u32 budget)
 		tx_info = &tx_ring->tx_buffer_info[req_id];
 		skb = tx_info->skb;
 
+		ena_tx_lat_sample_complete(tx_ring, req_id);
+
 		if (skb) {
 			netif_dbg(tx_ring->adapter, tx_done, tx_ring->netdev,
 				  "tx_poll: q %d skb %p completed\n",
@@ -1126,7 +1225,7 @@ static int ena_clean_tx_irq(struct ena_ring *tx_ring, u32 budget)
 			}
 
 #ifdef ENA_SUPPORT_BUILD_AND_CONSUME_SKB
-			napi_consume_skb(skb, budget);
+			napi_consume_skb(skb, in_napi ? budget : 0);
 #else
 			dev_kfree_skb(skb);
 #endif /* ENA_SUPPORT_BUILD_AND_CONSUME_SKB */
@@ -1152,6 +1251,7 @@ static int ena_clean_tx_irq(struct ena_ring *tx_ring, u32 budget)
 		if (unlikely(tx_info->timed_out))
 			missed_tx++;
 
+		ena_tx_pending_completed(tx_ring, tx_info->tx_sent_jiffies);
 		tx_info->tx_sent_jiffies = 0;
 
 		tx_bytes += tx_info->total_tx_size;
@@ -1175,6 +1275,17 @@ static int ena_clean_tx_irq(struct ena_ring *tx_ring, u32 budget)
 	netif_dbg(tx_ring->adapter, tx_done, tx_ring->netdev,
 		  "tx_poll: q %d done. total pkts: %d\n",
 		  tx_ring->qid, tx_pkts);
+	if (tx_pkts)
+		ena_fr_record(tx_ring->flight_recorder,
+			      ENA_FR_EVENT_TX_COMPLETION, next_to_clean, tx_pkts);
+	trace_ena_clean_tx_irq(tx_ring->netdev->ifindex, tx_ring->qid, budget,
+			       tx_pkts, total_done);
+
+	/* The transmit path holds the Tx queue lock, and the queue can't be
+	 * stopped while it runs
+	 */
+	if (!in_napi)
+		return tx_pkts;
 
 	/* need to make the rings circular update visible to
 	 * ena_start_xmit() before checking for netif_queue_stopped().
@@ -1742,6 +1853,12 @@ static int ena_clean_rx_irq(struct ena_ring *rx_ring, struct napi_struct *napi,
 		min_t(int, rx_ring->ring_size / ENA_RX_REFILL_THRESH_DIVIDER,
 		      ENA_RX_REFILL_THRESH_PACKET);
 
+	if (work_done)
+		ena_fr_record(rx_ring->flight_recorder,
+			      ENA_FR_EVENT_RX_COMPLETION, next_to_clean, work_done);
+	trace_ena_clean_rx_irq(rx_ring->netdev->ifindex, rx_ring->qid, budget,
+			       work_done, refill_required);
+
 	/* Optimization, try to batch new rx buffers */
 	if (refill_required > refill_threshold)
 		ena_refill_rx_bufs(rx_ring, refill_required);
@@ -1859,6 +1976,8 @@ void ena_unmask_interrupt(struct ena_ring *tx_ring,
 
 	ena_increase_stat(&tx_ring->tx_stats.unmask_interrupt, 1,
 			  &tx_ring->syncp);
+	ena_fr_record(rx_ring->flight_recorder, ENA_FR_EVENT_UNMASK_INTR,
+		      rx_ring->next_to_clean, lost_interrupt);
 
 	/* It is a shared MSI-X.
 	 * Tx and Rx CQ have pointer to it.
@@ -1924,7 +2043,25 @@ static int ena_io_poll(struct napi_struct *napi, int budget)
 				  1, &rx_ring->syncp);
 
 #endif /* ENA_HAVE_NAPI_STATE_BUSY_POLL */
-	tx_work_done = ena_clean_tx_irq(tx_ring, tx_budget);
+	/* Write a Tx doorbell deferred by ena_xmit_doorbell() */
+	if (tx_ring->tx_db_coalesce_pkts && READ_ONCE(tx_ring->tx_db_pending_pkts))
+		ena_ring_tx_doorbell_locked(tx_ring->adapter, tx_ring->qid);
+
+	if (tx_ring->xmit_reap_budget) {
+		/* The lock may be held by ena_xmit_reap() on this CPU when the
+		 * poll runs from netpoll, so never spin on it. If the xmit path
+		 * is cleaning the ring, report a full Tx budget to be polled
+		 * again instead of unmasking the interrupt.
+		 */
+		if (spin_trylock(&tx_ring->tx_clean_lock)) {
+			tx_work_done = ena_clean_tx_irq(tx_ring, tx_budget, true);
+			spin_unlock(&tx_ring->tx_clean_lock);
+		} else {
+			tx_work_done = tx_budget;
+		}
+	} else {
+		tx_work_done = ena_clean_tx_irq(tx_ring, tx_budget, true);
+	}
 	/* On netpoll the budget is zero and the handler should only clean the
 	 * tx completions.
 	 */
@@ -1939,6 +2076,24 @@ static int ena_io_poll(struct napi_struct *napi, int budget)
 		napi_complete_done(napi, 0);
 		ret = 0;
 
+	} else if (ena_napi->poll_mode) {
+		/* Interrupts stay masked. Keep NAPI scheduled while there is
+		 * work, and poll an idle queue again after the backoff.
+		 */
+		ret = budget;
+
+		if (ena_napi->poll_idle_backoff_ns && !rx_work_done && !tx_work_done) {
+			napi_comp_call = 1;
+			ret = 0;
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 10, 0)
+			if (napi_complete_done(napi, 0))
+#else
+			napi_complete_done(napi, 0);
+#endif
+				hrtimer_start(&ena_napi->poll_timer,
+					      ns_to_ktime(ena_napi->poll_idle_backoff_ns),
+					      HRTIMER_MODE_REL_PINNED);
+		}
 	} else if ((budget > rx_work_done) && (tx_budget > tx_work_done)) {
 		napi_comp_call = 1;
 
@@ -2103,9 +2258,150 @@ static void ena_setup_mgmnt_intr(struct ena_adapter *adapter)
 			&adapter->irq_tbl[ENA_MGMNT_IRQ_IDX].affinity_hint_mask);
 }
 
+int ena_set_irq_policy(struct ena_adapter *adapter, u32 policy, const char *cpu_list)
+{
+	cpumask_var_t cpus;
+	int rc;
+
+	if (policy >= ENA_IRQ_POLICY_MAX) {
+		netdev_err(adapter->netdev, "Invalid IRQ policy %u\n", policy);
+		return -EINVAL;
+	}
+
+	/* An empty list keeps the previously configured one */
+	if (cpu_list && *cpu_list) {
+		if (!zalloc_cpumask_var(&cpus, GFP_KERNEL))
+			return -ENOMEM;
+
+		rc = cpulist_parse(cpu_list, cpus);
+		if (!rc)
+			cpumask_copy(&adapter->irq_cpu_list, cpus);
+
+		free_cpumask_var(cpus);
+
+		if (rc) {
+			netdev_err(adapter->netdev, "Invalid IRQ CPU list %s\n", cpu_list);
+			return rc;
+		}
+	}
+
+	if (policy == ENA_IRQ_POLICY_CPU_LIST && cpumask_empty(&adapter->irq_cpu_list)) {
+		netdev_err(adapter->netdev, "IRQ CPU list policy requires a CPU list\n");
+		return -EINVAL;
+	}
+
+	adapter->irq_policy = policy;
+
+	return 0;
+}
+
+/* Fill @cpus with the CPUs the IO IRQs may be placed on according to the
+ * adapter's IRQ policy. Falls back to all online CPUs if the policy leaves
+ * no online CPU.
+ */
+static void ena_irq_policy_cpus(struct ena_adapter *adapter, struct cpumask *cpus)
+{
+	enum ena_irq_policy policy = adapter->irq_policy;
+	int cpu;
+
+	if (policy == ENA_IRQ_POLICY_CPU_LIST) {
+		cpumask_and(cpus, &adapter->irq_cpu_list, cpu_online_mask);
+	} else {
+		cpumask_copy(cpus, cpu_online_mask);
+#ifdef ENA_HAVE_HK_TYPE
+		/* Skip CPUs isolated with isolcpus= or nohz_full= */
+		cpumask_and(cpus, cpus, housekeeping_cpumask(HK_TYPE_MANAGED_IRQ));
+		cpumask_and(cpus, cpus, housekeeping_cpumask(HK_TYPE_DOMAIN));
+#endif /* ENA_HAVE_HK_TYPE */
+	}
+
+	/* Keep a single hardware thread of every core */
+	if (policy == ENA_IRQ_POLICY_PHYS_CORES) {
+		for_each_cpu(cpu, cpus) {
+			cpumask_andnot(cpus, cpus, topology_sibling_cpumask(cpu));
+			cpumask_set_cpu(cpu, cpus);
+		}
+	}
+
+	if (cpumask_empty(cpus)) {
+		netif_warn(adapter, ifup, adapter->netdev,
+			   "IRQ policy %u leaves no online CPU, using all online CPUs\n",
+			   policy);
+		cpumask_copy(cpus, cpu_online_mask);
+	}
+}
+
+/* Same as cpumask_local_spread() but restricted to @cpus */
+static int ena_irq_policy_spread(const struct cpumask *cpus, unsigned int i, int node)
+{
+	const struct cpumask *node_mask = cpu_online_mask;
+	int cpu;
+
+	if (node != NUMA_NO_NODE)
+		node_mask = cpumask_of_node(node);
+
+	i %= cpumask_weight(cpus);
+
+	for_each_cpu_and(cpu, cpus, node_mask)
+		if (i-- == 0)
+			return cpu;
+
+	for_each_cpu(cpu, cpus) {
+		if (cpumask_test_cpu(cpu, node_mask))
+			continue;
+
+		if (i-- == 0)
+			return cpu;
+	}
+
+	return cpumask_first(cpus);
+}
+
+/* Pin the TX queue of every IO queue to the CPU of its IRQ and to the RX queue
+ * it shares the IRQ with, so that both directions of a flow are handled on the
+ * same core. The maps are cleared when switching back to the default policy.
+ */
+static void ena_set_xps_maps(struct ena_adapter *adapter)
+{
+#ifdef CONFIG_XPS
+	struct net_device *netdev = adapter->netdev;
+#ifdef ENA_HAVE_XPS_RXQS
+	DECLARE_BITMAP(rxqs, ENA_MAX_NUM_IO_QUEUES);
+#endif /* ENA_HAVE_XPS_RXQS */
+	bool clear_maps;
+	int i, rc, cpu;
+
+	clear_maps = adapter->irq_policy == ENA_IRQ_POLICY_LOCAL;
+	if (clear_maps && !adapter->xps_maps_set)
+		return;
+
+	for (i = 0; i < adapter->num_io_queues; i++) {
+		cpu = adapter->irq_tbl[ENA_IO_IRQ_IDX(i)].cpu;
+
+		rc = netif_set_xps_queue(netdev,
+					 clear_maps ? cpu_none_mask : cpumask_of(cpu), i);
+#ifdef ENA_HAVE_XPS_RXQS
+		if (!rc) {
+			bitmap_zero(rxqs, ENA_MAX_NUM_IO_QUEUES);
+			if (!clear_maps)
+				__set_bit(i, rxqs);
+			rc = __netif_set_xps_queue(netdev, rxqs, i, XPS_RXQS);
+		}
+#endif /* ENA_HAVE_XPS_RXQS */
+		if (rc)
+			netif_warn(adapter, ifup, netdev,
+				   "Failed to set XPS map of queue %d, rc: %d\n", i, rc);
+	}
+
+	adapter->xps_maps_set = !clear_maps;
+#endif /* CONFIG_XPS */
+}
+
 static void ena_setup_io_intr(struct ena_adapter *adapter)
 {
 	const struct cpumask *affinity = cpu_online_mask;
+	bool use_policy = false;
+	cpumask_var_t policy_cpus;
 	int irq_idx, i, cpu, node;
 	struct net_device *netdev;
 
@@ -2115,9 +2411,21 @@ static void ena_setup_io_intr(struct ena_adapter *adapter)
 	if (node != NUMA_NO_NODE)
 		affinity = cpumask_of_node(node);
 
+	/* Each IRQ is pinned to a single CPU chosen by the policy */
+	if (adapter->irq_policy != ENA_IRQ_POLICY_LOCAL &&
+	    zalloc_cpumask_var(&policy_cpus, GFP_KERNEL)) {
+		ena_irq_policy_cpus(adapter, policy_cpus);
+		use_policy = true;
+	}
+
 	for (i = 0; i < adapter->num_io_queues; i++) {
 		irq_idx = ENA_IO_IRQ_IDX(i);
-		cpu = cpumask_local_spread(i, node);
+		if (use_policy) {
+			cpu = ena_irq_policy_spread(policy_cpus, i, node);
+			affinity = cpumask_of(cpu);
+		} else {
+			cpu = cpumask_local_spread(i, node);
+		}
 		snprintf(adapter->irq_tbl[irq_idx].name, ENA_IRQNAME_SIZE,
 			 "%s-Tx-Rx-%d", netdev->name, i);
 		adapter->irq_tbl[irq_idx].handler = ena_intr_msix_io;
@@ -2132,6 +2440,9 @@ static void ena_setup_io_intr(struct ena_adapter *adapter)
 
 		cpumask_copy(&adapter->irq_tbl[irq_idx].affinity_hint_mask, affinity);
 	}
+
+	if (use_policy)
+		free_cpumask_var(policy_cpus);
 }
 
 static int ena_request_mgmnt_irq(struct ena_adapter *adapter)
@@ -2284,6 +2595,99 @@ static void ena_del_napi(struct ena_adapter *adapter)
 #endif /* ENA_BUSY_POLL_SUPPORT */
 }
 
+static enum hrtimer_restart ena_poll_timer_fn(struct hrtimer *timer)
+{
+	struct ena_napi *ena_napi = container_of(timer, struct ena_napi, poll_timer);
+
+	napi_schedule(&ena_napi->napi);
+
+	return HRTIMER_NORESTART;
+}
+
+/* The deferred Tx doorbell is written by the NAPI poll */
+static enum hrtimer_restart ena_tx_db_timer_fn(struct hrtimer *timer)
+{
+	struct ena_napi *ena_napi = container_of(timer, struct ena_napi, tx_db_timer);
+
+	napi_schedule(&ena_napi->napi);
+
+	return HRTIMER_NORESTART;
+}
+
+/* Poll mode queues are polled by a NAPI thread pinned to the CPU of the
+ * queue's IRQ. Threaded NAPI can only be enabled for the whole device, so the
+ * other queues are polled by their own NAPI threads as well. Without threaded
+ * NAPI, a poll mode queue would keep its softirq busy, so poll mode is turned
+ * off instead.
+ */
+static void ena_setup_poll_mode(struct ena_adapter *adapter)
+{
+	struct net_device *netdev = adapter->netdev;
+	int i, rc = -EOPNOTSUPP;
+#ifdef ENA_HAVE_THREADED_NAPI
+	struct ena_napi *ena_napi;
+	int cpu;
+#endif /* ENA_HAVE_THREADED_NAPI */
+
+	if (bitmap_empty(adapter->poll_mode_queues, adapter->num_io_queues))
+		return;
+
+#ifdef ENA_HAVE_THREADED_NAPI
+	/* Threaded NAPI may have been enabled by the user already */
+	if (netdev->threaded) {
+		rc = 0;
+	} else {
+		rc = dev_set_threaded(netdev, true);
+		adapter->poll_mode_threaded_napi = !rc;
+	}
+
+	if (!rc) {
+		for (i = 0; i < adapter->num_io_queues; i++) {
+			ena_napi = &adapter->ena_napi[i];
+			if (!ena_napi->poll_mode || !ena_napi->napi.thread)
+				continue;
+
+			cpu = adapter->irq_tbl[ENA_IO_IRQ_IDX(i)].cpu;
+			set_cpus_allowed_ptr(ena_napi->napi.thread, cpumask_of(cpu));
+		}
+
+		return;
+	}
+
+#endif /* ENA_HAVE_THREADED_NAPI */
+	netif_warn(adapter, ifup, netdev,
+		   "Threaded NAPI is unavailable, rc: %d. Poll mode is disabled\n", rc);
+
+	for (i = 0; i < adapter->num_io_queues; i++)
+		adapter->ena_napi[i].poll_mode = false;
+}
+
+/* Restore the threaded NAPI state from before ena_setup_poll_mode(). Must be
+ * called after the NAPI instances are deleted.
+ */
+static void ena_teardown_poll_mode(struct ena_adapter *adapter)
+{
+#ifdef ENA_HAVE_THREADED_NAPI
+	if (!adapter->poll_mode_threaded_napi)
+		return;
+
+	dev_set_threaded(adapter->netdev, false);
+	adapter->poll_mode_threaded_napi = false;
+#endif /* ENA_HAVE_THREADED_NAPI */
+}
+
+static void ena_cancel_napi_timers(struct ena_adapter *adapter)
+{
+	int i;
+
+	for (i = 0; i < adapter->num_io_queues; i++) {
+		if (adapter->ena_napi[i].poll_mode)
+			hrtimer_cancel(&adapter->ena_napi[i].poll_timer);
+
+		hrtimer_cancel(&adapter->ena_napi[i].tx_db_timer);
+	}
+}
+
 static void ena_init_napi(struct ena_adapter *adapter)
 {
 	int (*napi_handler)(struct napi_struct *napi, int budget);
@@ -2314,6 +2718,17 @@ static void ena_init_napi(struct ena_adapter *adapter)
 		napi->tx_ring = tx_ring;
 		napi->qid = i;
 		napi->lost_interrupt_unmask_handled = false;
+
+		napi->poll_mode = test_bit(i, adapter->poll_mode_queues);
+#ifdef ENA_AF_XDP_SUPPORT
+		if (ENA_IS_XSK_RING(rx_ring))
+			napi->poll_mode = false;
+#endif /* ENA_AF_XDP_SUPPORT */
+		napi->poll_idle_backoff_ns = adapter->poll_idle_backoff_us * NSEC_PER_USEC;
+		hrtimer_setup(&napi->poll_timer, ena_poll_timer_fn, CLOCK_MONOTONIC,
+			      HRTIMER_MODE_REL_PINNED);
+		hrtimer_setup(&napi->tx_db_timer, ena_tx_db_timer_fn, CLOCK_MONOTONIC,
+			      HRTIMER_MODE_REL_PINNED);
 	}
 }
 
@@ -2614,6 +3029,11 @@ static int ena_create_page_pool(struct ena_adapter *adapter)
 	struct ena_ring *rx_ring;
 	int rc, i;
 
+	/* PP_FLAG_ALLOW_UNREADABLE_NETMEM isn't set since the device doesn't
+	 * split the headers from the payload, and the headers are read from
+	 * the Rx buffer itself. The pools are therefore never backed by a
+	 * memory provider.
+	 */
 	pp_params.flags = PP_FLAG_DMA_MAP | PP_FLAG_DMA_SYNC_DEV;
 	pp_params.dma_dir = DMA_BIDIRECTIONAL;
 	pp_params.max_len = ENA_PAGE_SIZE;
@@ -2815,6 +3235,7 @@ int ena_up(struct ena_adapter *adapter)
 	 * function wasn't set yet, causing a null dereference
 	 */
 	ena_init_napi(adapter);
+	ena_setup_poll_mode(adapter);
 
 	/* If the device stopped supporting interrupt moderation, need
 	 * to disable adaptive interrupt moderation.
@@ -2851,6 +3272,8 @@ int ena_up(struct ena_adapter *adapter)
 	if (unlikely(rc))
 		goto err_up;
 
+	ena_set_xps_maps(adapter);
+
 	if (test_bit(ENA_FLAG_LINK_UP, &adapter->flags))
 		netif_carrier_on(adapter->netdev);
 
@@ -2859,11 +3282,14 @@ int ena_up(struct ena_adapter *adapter)
 
 	set_bit(ENA_FLAG_DEV_UP, &adapter->flags);
 
-	/* Enable completion queues interrupt */
+	/* Enable completion queues interrupt. Poll mode queues keep their
+	 * interrupts masked.
+	 */
 	for (i = 0; i < adapter->num_io_queues; i++)
-		ena_unmask_interrupt(&adapter->tx_ring[i],
-				     &adapter->rx_ring[i],
-				     false);
+		if (!adapter->ena_napi[i].poll_mode)
+			ena_unmask_interrupt(&adapter->tx_ring[i],
+					     &adapter->rx_ring[i],
+					     false);
 
 	/* schedule napi in case we had pending packets
 	 * from the last time we disable napi
@@ -2885,6 +3311,7 @@ err_create_queues_with_backoff:
 	ena_free_io_irq(adapter);
 err_req_irq:
 	ena_del_napi(adapter);
+	ena_teardown_poll_mode(adapter);
 
 	return rc;
 }
@@ -2903,6 +3330,7 @@ void ena_down(struct ena_adapter *adapter)
 
 	/* After this point the napi handler won't enable the tx queue */
 	ena_napi_disable(adapter);
+	ena_cancel_napi_timers(adapter);
 
 	if (test_bit(ENA_FLAG_TRIGGER_RESET, &adapter->flags)) {
 		struct ena_com_dev *ena_dev = adapter->ena_dev;
@@ -2929,6 +3357,7 @@ void ena_down(struct ena_adapter *adapter)
 	ena_disable_io_intr_sync(adapter);
 	ena_free_io_irq(adapter);
 	ena_del_napi(adapter);
+	ena_teardown_poll_mode(adapter);
 
 	ena_free_all_tx_bufs(adapter);
 	ena_free_all_rx_bufs(adapter);
@@ -3089,6 +3518,7 @@ int ena_update_queue_params(struct ena_adapter *adapter,
 		adapter->llq_policy = large_llq_requested ?
 					ENA_LLQ_HEADER_SIZE_POLICY_LARGE :
 					ENA_LLQ_HEADER_SIZE_POLICY_NORMAL;
+		adapter->large_llq_auto = false;
 
 		rc = ena_destroy_device(adapter, false);
 		rc |= ena_restore_device(adapter);
@@ -3176,6 +3606,13 @@ static void ena_tx_csum(struct ena_com_tx_ctx *ena_tx_ctx,
 	u32 mss = skb_shinfo(skb)->gso_size;
 	u8 l4_protocol = 0;
 
+#ifdef ENA_UDP_GSO_SUPPORT
+	/* UDP GSO packets are segmented by the driver */
+	if (skb_shinfo(skb)->gso_type & SKB_GSO_UDP_L4)
+		mss = 0;
+
+#endif /* ENA_UDP_GSO_SUPPORT */
+
 	if ((skb->ip_summed == CHECKSUM_PARTIAL) || mss) {
 		ena_tx_ctx->l4_csum_enable = 1;
 		if (mss) {
@@ -3331,6 +3768,412 @@ error_report_dma_error:
 	return rc;
 }
 
+/* Length of the packet's headers up to the end of the L4 header (the inner
+ * one for encapsulated packets), or 0 if it isn't known
+ */
+static u32 ena_tx_hdr_len(struct sk_buff *skb)
+{
+	u32 l4_offset;
+
+	if (skb->ip_summed != CHECKSUM_PARTIAL)
+		return 0;
+
+	l4_offset = skb_checksum_start_offset(skb);
+	if (skb->csum_offset == offsetof(struct udphdr, check))
+		return l4_offset + sizeof(struct udphdr);
+
+	if (skb->csum_offset != offsetof(struct tcphdr, check) ||
+	    l4_offset + sizeof(struct tcphdr) > skb_headlen(skb))
+		return 0;
+
+	return l4_offset + ((struct tcphdr *)(skb->data + l4_offset))->doff * 4;
+}
+
+static void ena_update_tx_hdr_len_stats(struct ena_ring *tx_ring, struct sk_buff *skb)
+{
+	struct ena_stats_tx *tx_stats = &tx_ring->tx_stats;
+	u32 hdr_len = ena_tx_hdr_len(skb);
+	u64 *stat;
+
+	if (!hdr_len)
+		return;
+
+	if (hdr_len <= 64)
+		stat = &tx_stats->hdr_len_64;
+	else if (hdr_len <= ENA_LLQ_HEADER)
+		stat = &tx_stats->hdr_len_96;
+	else if (hdr_len <= 128)
+		stat = &tx_stats->hdr_len_128;
+	else if (hdr_len <= 160)
+		stat = &tx_stats->hdr_len_160;
+	else if (hdr_len <= ENA_LLQ_LARGE_HEADER)
+		stat = &tx_stats->hdr_len_224;
+	else
+		stat = &tx_stats->hdr_len_above_224;
+
+	u64_stats_update_begin(&tx_ring->syncp);
+	(*stat)++;
+	if (hdr_len > tx_ring->tx_max_header_size)
+		tx_stats->hdr_len_above_llq++;
+	u64_stats_update_end(&tx_ring->syncp);
+}
+
+/* Clean Tx completions from the transmit path once the ring runs low on
+ * space, so that the queue doesn't need to be stopped and woken up by the
+ * next NAPI poll. Called with netif_tx_lock.
+ */
+static void ena_xmit_reap(struct ena_ring *tx_ring)
+{
+	int reaped;
+
+#ifdef ENA_AF_XDP_SUPPORT
+	if (ENA_IS_XSK_RING(tx_ring))
+		return;
+
+#endif /* ENA_AF_XDP_SUPPORT */
+	if (likely(ena_com_sq_have_enough_space(tx_ring->ena_com_io_sq,
+						tx_ring->ring_size / ENA_TX_REAP_THRESH_DIVIDER)))
+		return;
+
+	/* NAPI is already cleaning the ring. Don't wait for it since it may
+	 * need the Tx queue lock to wake up the queue.
+	 */
+	if (!spin_trylock(&tx_ring->tx_clean_lock))
+		return;
+
+	reaped = ena_clean_tx_irq(tx_ring, tx_ring->xmit_reap_budget, false);
+	spin_unlock(&tx_ring->tx_clean_lock);
+
+	if (reaped)
+		ena_increase_stat(&tx_ring->tx_stats.xmit_reap, reaped,
+				  &tx_ring->syncp);
+}
+
+#ifdef ENA_UDP_GSO_SUPPORT
+/* Upper bound of the LLQ entries used by each segment of a UDP GSO packet */
+static u32 ena_udp_gso_seg_entries(struct ena_ring *tx_ring, struct sk_buff *skb)
+{
+	u32 bufs = min_t(u32, skb_shinfo(skb)->nr_frags + 1, tx_ring->sgl_size);
+
+	/* One more descriptor for the meta descriptor and one more entry for
+	 * the header
+	 */
+	return DIV_ROUND_UP(bufs + 1, tx_ring->ena_com_io_sq->llq_info.descs_per_entry) + 1;
+}
+
+/* Check that all the segments fit in the ring, so ena_com_prepare_tx() can't
+ * fail on one of them after the previous ones were posted
+ */
+static bool ena_udp_gso_have_enough_space(struct ena_ring *tx_ring, u32 entries)
+{
+	struct ena_com_io_sq *io_sq = tx_ring->ena_com_io_sq;
+
+	return ena_com_sq_have_enough_space(io_sq,
+					    entries * io_sq->llq_info.descs_per_entry);
+}
+
+static bool ena_udp_gso_supported(struct ena_ring *tx_ring, struct sk_buff *skb)
+{
+	u32 hdr_len = skb_transport_offset(skb) + sizeof(struct udphdr);
+	struct skb_shared_info *shinfo = skb_shinfo(skb);
+
+	if (tx_ring->tx_mem_queue_type != ENA_ADMIN_PLACEMENT_POLICY_DEV)
+		return false;
+
+#ifdef ENA_AF_XDP_SUPPORT
+	if (ENA_IS_XSK_RING(tx_ring))
+		return false;
+
+#endif /* ENA_AF_XDP_SUPPORT */
+	if (skb->encapsulation || skb->ip_summed != CHECKSUM_PARTIAL)
+		return false;
+
+	/* The headers are copied to the push buffer and the payload must start
+	 * in the linear part or in the fragments
+	 */
+	if (hdr_len > tx_ring->tx_max_header_size || hdr_len > skb_headlen(skb))
+		return false;
+
+	if (shinfo->nr_frags + 1 > tx_ring->sgl_size)
+		return false;
+
+	/* Hardware timestamps are reported for a single packet */
+	if (unlikely(shinfo->tx_flags & SKBTX_HW_TSTAMP))
+		return false;
+
+	return shinfo->gso_segs * ena_udp_gso_seg_entries(tx_ring, skb) <=
+	       tx_ring->ring_size / ENA_UDP_GSO_RING_DIVIDER;
+}
+
+/* UDP GSO packets which can't be segmented by the driver are segmented by the
+ * stack
+ */
+static netdev_features_t ena_features_check(struct sk_buff *skb,
+					    struct net_device *dev,
+					    netdev_features_t features)
+{
+	struct ena_adapter *adapter = netdev_priv(dev);
+	struct ena_ring *tx_ring;
+
+	features = vlan_features_check(skb, features);
+
+	if (!skb_is_gso(skb) || !(skb_shinfo(skb)->gso_type & SKB_GSO_UDP_L4))
+		return features;
+
+	tx_ring = &adapter->tx_ring[skb_get_queue_mapping(skb)];
+	if (!ena_udp_gso_supported(tx_ring, skb))
+		features &= ~NETIF_F_GSO_UDP_L4;
+
+	return features;
+}
+
+/* Map the payload of a single segment of a UDP GSO packet. The mapping
+ * continues from where the previous segment ended, which is tracked by
+ * @lin_off in the linear part and by @frag_idx and @frag_off in the fragments.
+ */
+static int ena_tx_map_udp_gso_seg(struct ena_ring *tx_ring,
+				  struct ena_tx_buffer *tx_info,
+				  struct sk_buff *skb,
+				  u32 seg_len,
+				  u32 *lin_off,
+				  u32 *frag_idx,
+				  u32 *frag_off)
+{
+	struct ena_adapter *adapter = tx_ring->adapter;
+	struct ena_com_buf *ena_buf = tx_info->bufs;
+	u32 skb_head_len = skb_headlen(skb);
+	const skb_frag_t *frag;
+	dma_addr_t dma;
+	u32 len;
+	int rc;
+
+	tx_info->num_of_bufs = 0;
+	tx_info->map_linear_data = 0;
+
+	if (*lin_off < skb_head_len) {
+		len = min(skb_head_len - *lin_off, seg_len);
+		dma = dma_map_single(tx_ring->dev, skb->data + *lin_off, len,
+				     DMA_TO_DEVICE);
+		rc = dma_mapping_error(tx_ring->dev, dma);
+		if (unlikely(rc))
+			goto error_report_dma_error;
+
+		ena_buf->paddr = dma;
+		ena_buf->len = len;
+		ena_buf++;
+		tx_info->num_of_bufs++;
+		tx_info->map_linear_data = 1;
+
+		*lin_off += len;
+		seg_len -= len;
+	}
+
+	while (seg_len) {
+		frag = &skb_shinfo(skb)->frags[*frag_idx];
+		len = min(skb_frag_size(frag) - *frag_off, seg_len);
+
+		dma = skb_frag_dma_map(tx_ring->dev, frag, *frag_off, len,
+				       DMA_TO_DEVICE);
+		rc = dma_mapping_error(tx_ring->dev, dma);
+		if (unlikely(rc))
+			goto error_report_dma_error;
+
+		ena_buf->paddr = dma;
+		ena_buf->len = len;
+		ena_buf++;
+		tx_info->num_of_bufs++;
+
+		*frag_off += len;
+		seg_len -= len;
+		if (*frag_off == skb_frag_size(frag)) {
+			(*frag_idx)++;
+			*frag_off = 0;
+		}
+	}
+
+	return 0;
+
+error_report_dma_error:
+	ena_increase_stat(&tx_ring->tx_stats.dma_mapping_err, 1,
+			  &tx_ring->syncp);
+	netif_warn(adapter, tx_queued, adapter->netdev, "Failed to map skb\n");
+
+	ena_unmap_tx_buff(tx_ring, tx_info);
+
+	return rc;
+}
+
+/* Transmit a UDP GSO packet by posting each of its segments to the LLQ.
+ * The headers of each segment are built in the push buffer, and its payload
+ * is mapped directly from the skb, so no skb is allocated per segment.
+ * Each segment holds a reference to the skb, the last one takes over the
+ * caller's reference. The caller rings the doorbell once for all segments.
+ * Returns the number of segments posted, or -EBUSY if the ring doesn't have
+ * room for all of them.
+ */
+static int ena_xmit_udp_gso(struct ena_ring *tx_ring, struct sk_buff *skb)
+{
+	u32 hdr_len = skb_transport_offset(skb) + sizeof(struct udphdr);
+	u8 *hdr = tx_ring->push_buf_intermediate_buf;
+	u32 seg_len, mss = skb_shinfo(skb)->gso_size;
+	struct ena_adapter *adapter = tx_ring->adapter;
+	u32 frag_idx = 0, frag_off = 0, lin_off;
+	u32 remaining = skb->len - hdr_len;
+	struct ena_com_tx_ctx ena_tx_ctx;
+	struct ena_tx_buffer *tx_info;
+	u16 next_to_use, req_id, ip_id;
+	__be16 orig_len, seg_udp_len;
+	struct netdev_queue *txq;
+	struct ipv6hdr *ip6h;
+	u32 entries, segs, i;
+	struct iphdr *iph;
+	struct udphdr *uh;
+	__sum16 orig_csum;
+	bool is_ipv4;
+	int rc;
+
+	/* The placement policy may have changed since ena_features_check() */
+	if (unlikely(tx_ring->tx_mem_queue_type != ENA_ADMIN_PLACEMENT_POLICY_DEV))
+		return -EINVAL;
+
+	segs = DIV_ROUND_UP(remaining, mss);
+	entries = segs * ena_udp_gso_seg_entries(tx_ring, skb);
+	if (unlikely(!ena_udp_gso_have_enough_space(tx_ring, entries))) {
+		txq = netdev_get_tx_queue(tx_ring->netdev, tx_ring->qid);
+		netif_tx_stop_queue(txq);
+		ena_increase_stat(&tx_ring->tx_stats.queue_stop, 1,
+				  &tx_ring->syncp);
+
+		/* Same as in ena_start_xmit(), make sure the stop is visible
+		 * before checking the ring space again
+		 */
+		smp_mb();
+
+		if (!ena_udp_gso_have_enough_space(tx_ring, entries))
+			return -EBUSY;
+
+		netif_tx_wake_queue(txq);
+		ena_increase_stat(&tx_ring->tx_stats.queue_wakeup, 1,
+				  &tx_ring->syncp);
+	}
+
+	/* The meta data is the same for all the segments, so it is cached by
+	 * the device after the first one
+	 */
+	memset(&ena_tx_ctx, 0x0, sizeof(struct ena_com_tx_ctx));
+	ena_tx_csum(&ena_tx_ctx, skb, tx_ring->disable_meta_caching);
+	ena_tx_ctx.push_header = hdr;
+	ena_tx_ctx.header_len = hdr_len;
+
+	memcpy(hdr, skb->data, hdr_len);
+	is_ipv4 = ip_hdr(skb)->version == IPVERSION;
+	iph = (struct iphdr *)(hdr + skb_network_offset(skb));
+	ip6h = (struct ipv6hdr *)(hdr + skb_network_offset(skb));
+	uh = (struct udphdr *)(hdr + skb_transport_offset(skb));
+	ip_id = ntohs(iph->id);
+	orig_len = uh->len;
+	orig_csum = uh->check;
+
+	lin_off = hdr_len;
+	for (i = 0; i < segs; i++) {
+		seg_len = min(remaining, mss);
+
+		/* The UDP checksum holds the pseudo header checksum, which
+		 * covers the UDP length
+		 */
+		seg_udp_len = htons(sizeof(struct udphdr) + seg_len);
+		uh->len = seg_udp_len;
+		uh->check = csum16_add(csum16_sub(orig_csum, orig_len), seg_udp_len);
+
+		if (is_ipv4) {
+			iph->tot_len = htons(hdr_len - skb_network_offset(skb) + seg_len);
+			iph->id = htons(ip_id + i);
+			ip_send_check(iph);
+		} else {
+			ip6h->payload_len = htons(hdr_len - skb_network_offset(skb) -
+						  sizeof(struct ipv6hdr) + seg_len);
+		}
+
+		next_to_use = tx_ring->next_to_use;
+		req_id = tx_ring->free_ids[next_to_use];
+		tx_info = &tx_ring->tx_buffer_info[req_id];
+
+		WARN(tx_info->total_tx_size, "TX descriptor is still in use, req_iq = %d\n", req_id);
+
+		rc = ena_tx_map_udp_gso_seg(tx_ring, tx_info, skb, seg_len,
+					    &lin_off, &frag_idx, &frag_off);
+		if (unlikely(rc))
+			return rc;
+
+		ena_tx_ctx.ena_bufs = tx_info->bufs;
+		ena_tx_ctx.num_bufs = tx_info->num_of_bufs;
+		ena_tx_ctx.req_id = req_id;
+
+		rc = ena_xmit_common(adapter,
+				     tx_ring,
+				     tx_info,
+				     &ena_tx_ctx,
+				     next_to_use,
+				     hdr_len + seg_len);
+		if (unlikely(rc)) {
+			ena_unmap_tx_buff(tx_ring, tx_info);
+			return rc;
+		}
+
+		tx_info->skb = (i == segs - 1) ? skb : skb_get(skb);
+
+		ena_update_tx_stats(tx_ring, 1, hdr_len + seg_len);
+		ena_update_tx_hdr_len_stats(tx_ring, skb);
+		remaining -= seg_len;
+	}
+
+	ena_increase_stat(&tx_ring->tx_stats.udp_gso, 1, &tx_ring->syncp);
+
+	return segs;
+}
+
+#endif /* ENA_UDP_GSO_SUPPORT */
+/* Write the Tx doorbell at the end of a batch of packets. When doorbell
+ * coalescing is enabled the doorbell is deferred across batches, until enough
+ * packets or bytes are pending or the queue is stopped. A deferred doorbell
+ * is written by the next NAPI poll, which the doorbell timer schedules if no
+ * interrupt arrives first. Called with netif_tx_lock.
+ */
+static void ena_xmit_doorbell(struct ena_ring *tx_ring,
+			      struct netdev_queue *txq,
+			      u32 pkts,
+			      u32 bytes)
+{
+	struct ena_napi *ena_napi;
+
+	WRITE_ONCE(tx_ring->tx_db_pending_pkts, tx_ring->tx_db_pending_pkts + pkts);
+	tx_ring->tx_db_pending_bytes += bytes;
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(3, 18, 0)
+	if (!netif_xmit_stopped(txq) && netdev_xmit_more())
+		return;
+
+#endif
+	if (!tx_ring->tx_db_coalesce_pkts || netif_xmit_stopped(txq) ||
+	    tx_ring->tx_db_pending_pkts >= tx_ring->tx_db_coalesce_pkts ||
+	    tx_ring->tx_db_pending_bytes >= ENA_TX_DB_COALESCE_MAX_BYTES) {
+		/* trigger the dma engine. ena_ring_tx_doorbell()
+		 * calls a memory barrier inside it.
+		 */
+		ena_ring_tx_doorbell(tx_ring);
+		return;
+	}
+
+	ena_napi = container_of(tx_ring->napi, struct ena_napi, napi);
+	if (!hrtimer_active(&ena_napi->tx_db_timer))
+		hrtimer_start(&ena_napi->tx_db_timer,
+			      ns_to_ktime(tx_ring->tx_db_coalesce_ns),
+			      HRTIMER_MODE_REL_PINNED);
+
+	ena_increase_stat(&tx_ring->tx_stats.doorbells_deferred, 1,
+			  &tx_ring->syncp);
+}
+
 /* Called with netif_tx_lock. */
 static netdev_tx_t ena_start_xmit(struct sk_buff *skb, struct net_device *dev)
 {
@@ -3340,6 +4183,7 @@ static netdev_tx_t ena_start_xmit(struct sk_buff *skb, struct net_device *dev)
 	struct ena_tx_buffer *tx_info;
 	struct ena_ring *tx_ring;
 	struct netdev_queue *txq;
+	u32 pkts = 1;
 	void *push_hdr;
 	int qid, rc;
 
@@ -3349,6 +4193,27 @@ static netdev_tx_t ena_start_xmit(struct sk_buff *skb, struct net_device *dev)
 	tx_ring = &adapter->tx_ring[qid];
 	txq = netdev_get_tx_queue(dev, qid);
 
+#ifdef ENA_UDP_GSO_SUPPORT
+	if (skb_is_gso(skb) && (skb_shinfo(skb)->gso_type & SKB_GSO_UDP_L4)) {
+		rc = ena_xmit_udp_gso(tx_ring, skb);
+		if (unlikely(rc == -EBUSY)) {
+			/* Packets queued with xmit_more must be sent for the
+			 * queue to be woken up
+			 */
+			if (ena_com_used_q_entries(tx_ring->ena_com_io_sq))
+				ena_ring_tx_doorbell(tx_ring);
+
+			return NETDEV_TX_BUSY;
+		}
+
+		if (unlikely(rc < 0))
+			goto error_drop_packet;
+
+		pkts = rc;
+		goto xmit_done;
+	}
+
+#endif /* ENA_UDP_GSO_SUPPORT */
 	rc = ena_check_and_linearize_skb(tx_ring, skb);
 	if (unlikely(rc))
 		goto error_drop_packet;
@@ -3391,6 +4256,14 @@ static netdev_tx_t ena_start_xmit(struct sk_buff *skb, struct net_device *dev)
 		goto error_unmap_dma;
 
 	ena_update_tx_stats(tx_ring, 1, skb->len);
+	ena_update_tx_hdr_len_stats(tx_ring, skb);
+
+#ifdef ENA_UDP_GSO_SUPPORT
+xmit_done:
+#endif /* ENA_UDP_GSO_SUPPORT */
+	/* Netpoll transmits with interrupts disabled */
+	if (tx_ring->xmit_reap_budget && likely(!irqs_disabled()))
+		ena_xmit_reap(tx_ring);
 
 	/* stop the queue when no more space available, the packet can have up
 	 * to sgl_size + 2. one for the meta descriptor and one for header
@@ -3435,13 +4308,7 @@ static netdev_tx_t ena_start_xmit(struct sk_buff *skb, struct net_device *dev)
 
 	skb_tx_timestamp(skb);
 
-#if LINUX_VERSION_CODE >= KERNEL_VERSION(3, 18, 0)
-	if (netif_xmit_stopped(txq) || !netdev_xmit_more())
-#endif
-		/* trigger the dma engine. ena_ring_tx_doorbell()
-		 * calls a memory barrier inside it.
-		 */
-		ena_ring_tx_doorbell(tx_ring);
+	ena_xmit_doorbell(tx_ring, txq, pkts, skb->len);
 
 	return NETDEV_TX_OK;
 
@@ -3922,6 +4789,9 @@ static const struct net_device_ops ena_netdev_ops = {
 	.ndo_open		= ena_open,
 	.ndo_stop		= ena_close,
 	.ndo_start_xmit		= ena_start_xmit,
+#ifdef ENA_UDP_GSO_SUPPORT
+	.ndo_features_check	= ena_features_check,
+#endif /* ENA_UDP_GSO_SUPPORT */
 	.ndo_get_stats64	= ena_get_stats64,
 #ifdef HAVE_NDO_TX_TIMEOUT_STUCK_QUEUE_PARAMETER
 	.ndo_tx_timeout		= ena_tx_timeout,
@@ -3961,7 +4831,7 @@ static const struct net_device_ops ena_netdev_ops = {
 static void ena_accumulate_stats_rx(struct ena_ring *rx_ring,
 				    struct netdev_queue_stats_rx *stats)
 {
-	u64 bytes, packets, alloc_fail, csum_bad;
+	u64 bytes, packets, alloc_fail, csum_bad, csum_unnecessary;
 	unsigned int start;
 
 	do {
@@ -3971,12 +4841,14 @@ static void ena_accumulate_stats_rx(struct ena_ring *rx_ring,
 		alloc_fail = rx_ring->rx_stats.skb_alloc_fail +
 			     rx_ring->rx_stats.page_alloc_fail;
 		csum_bad = rx_ring->rx_stats.csum_bad;
+		csum_unnecessary = rx_ring->rx_stats.csum_good;
 	} while (ena_u64_stats_fetch_retry(&rx_ring->syncp, start));
 
 	stats->bytes += bytes;
 	stats->packets += packets;
 	stats->alloc_fail += alloc_fail;
 	stats->csum_bad += csum_bad;
+	stats->csum_unnecessary += csum_unnecessary;
 }
 
 static void ena_get_queue_stats_rx(struct net_device *netdev, int qid,
@@ -3990,6 +4862,7 @@ static void ena_get_queue_stats_rx(struct net_device *netdev, int qid,
 	stats->packets = 0;
 	stats->alloc_fail = 0;
 	stats->csum_bad = 0;
+	stats->csum_unnecessary = 0;
 	ena_accumulate_stats_rx(rx_ring, stats);
 }
 
@@ -4052,6 +4925,7 @@ static void ena_get_base_stats(struct net_device *netdev,
 	rx->packets = 0;
 	rx->alloc_fail = 0;
 	rx->csum_bad = 0;
+	rx->csum_unnecessary = 0;
 	tx->bytes = 0;
 	tx->packets = 0;
 	tx->stop = 0;
@@ -4211,6 +5085,77 @@ static int ena_device_validate_params(struct ena_adapter *adapter,
 	return 0;
 }
 
+#define ENA_LARGE_LLQ_AUTO_MIN_PKTS		100000ULL
+#define ENA_LARGE_LLQ_AUTO_LARGE_PERMILLE	10
+#define ENA_LARGE_LLQ_AUTO_NORMAL_PERMILLE	1
+
+/* Recommend large LLQ headers when more than 1% of the Tx packets have
+ * headers that fit only in a large LLQ header, and normal ones when less than
+ * 0.1% of them do. Returns ENA_LLQ_HEADER_SIZE_POLICY_UNSPECIFIED if there
+ * aren't enough samples or LLQ isn't used.
+ */
+enum ena_llq_header_size_policy_t ena_large_llq_recommendation(struct ena_adapter *adapter)
+{
+	u64 total = 0, large = 0, q_total, q_large;
+	struct ena_stats_tx *tx_stats;
+	unsigned int start;
+	int i;
+
+	if (adapter->ena_dev->tx_mem_queue_type != ENA_ADMIN_PLACEMENT_POLICY_DEV ||
+	    !adapter->large_llq_header_supported)
+		return ENA_LLQ_HEADER_SIZE_POLICY_UNSPECIFIED;
+
+	for (i = 0; i < adapter->num_io_queues; i++) {
+		tx_stats = &adapter->tx_ring[i].tx_stats;
+
+		do {
+			start = ena_u64_stats_fetch_begin(&adapter->tx_ring[i].syncp);
+			q_large = tx_stats->hdr_len_128 + tx_stats->hdr_len_160 +
+				  tx_stats->hdr_len_224;
+			q_total = q_large + tx_stats->hdr_len_64 + tx_stats->hdr_len_96 +
+				  tx_stats->hdr_len_above_224;
+		} while (ena_u64_stats_fetch_retry(&adapter->tx_ring[i].syncp, start));
+
+		total += q_total;
+		large += q_large;
+	}
+
+	if (total < ENA_LARGE_LLQ_AUTO_MIN_PKTS)
+		return ENA_LLQ_HEADER_SIZE_POLICY_UNSPECIFIED;
+
+	if (large * 1000 > total * ENA_LARGE_LLQ_AUTO_LARGE_PERMILLE)
+		return ENA_LLQ_HEADER_SIZE_POLICY_LARGE;
+
+	if (large * 1000 < total * ENA_LARGE_LLQ_AUTO_NORMAL_PERMILLE)
+		return ENA_LLQ_HEADER_SIZE_POLICY_NORMAL;
+
+	return ENA_LLQ_HEADER_SIZE_POLICY_UNSPECIFIED;
+}
+
+/* Called before the device is reinitialized on the user's request (devlink
+ * reload), which is when the LLQ header size can be changed. It isn't applied
+ * on error recovery resets, so the Tx ring size doesn't change under a
+ * running interface.
+ */
+void ena_apply_large_llq_recommendation(struct ena_adapter *adapter)
+{
+	enum ena_llq_header_size_policy_t recommended;
+
+	if (!adapter->large_llq_auto)
+		return;
+
+	recommended = ena_large_llq_recommendation(adapter);
+	if (recommended == ENA_LLQ_HEADER_SIZE_POLICY_UNSPECIFIED ||
+	    recommended == adapter->llq_policy)
+		return;
+
+	netif_info(adapter, drv, adapter->netdev,
+		   "Switching to %s LLQ headers according to the Tx headers length\n",
+		   recommended == ENA_LLQ_HEADER_SIZE_POLICY_LARGE ? "large" : "normal");
+
+	adapter->llq_policy = recommended;
+}
+
 static void ena_set_forced_llq_size_policy(struct ena_adapter *adapter)
 {
 	/* policy will be set according to device recommendation unless user
@@ -4220,7 +5165,10 @@ static void ena_set_forced_llq_size_policy(struct ena_adapter *adapter)
 		/* user selection is prioritized on top of device recommendation */
 		adapter->llq_policy = force_large_llq_header ? ENA_LLQ_HEADER_SIZE_POLICY_LARGE :
 							       ENA_LLQ_HEADER_SIZE_POLICY_NORMAL;
+		return;
 	}
+
+	adapter->large_llq_auto = !!large_llq_auto;
 }
 
 static void ena_set_llq_configurations(struct ena_adapter *adapter,
@@ -4240,11 +5188,16 @@ static void ena_set_llq_configurations(struct ena_adapter *adapter,
 		!!(llq->entry_size_ctrl_supported &
 			ENA_ADMIN_LIST_ENTRY_SIZE_256B);
 
+	adapter->llq_default_policy =
+		adapter->large_llq_header_supported &&
+		llq->entry_size_recommended == ENA_ADMIN_LIST_ENTRY_SIZE_256B ?
+		ENA_LLQ_HEADER_SIZE_POLICY_LARGE : ENA_LLQ_HEADER_SIZE_POLICY_NORMAL;
+
 	use_large_llq = adapter->llq_policy != ENA_LLQ_HEADER_SIZE_POLICY_NORMAL;
 	use_large_llq &= adapter->large_llq_header_supported;
 
 	if (adapter->llq_policy == ENA_LLQ_HEADER_SIZE_POLICY_UNSPECIFIED)
-		use_large_llq &= (llq->entry_size_recommended == ENA_ADMIN_LIST_ENTRY_SIZE_256B);
+		use_large_llq = adapter->llq_default_policy == ENA_LLQ_HEADER_SIZE_POLICY_LARGE;
 
 	if (!use_large_llq) {
 		llq_config->llq_ring_entry_size = ENA_ADMIN_LIST_ENTRY_SIZE_128B;
@@ -4438,9 +5391,12 @@ static int ena_device_init(struct ena_adapter *adapter, struct pci_dev *pdev,
 	ena_set_dev_offloads(get_feat_ctx, adapter);
 	adapter->netdev->features = prev_netdev_features;
 
-	rc = ena_phc_init(adapter);
-	if (unlikely(rc && (rc != -EOPNOTSUPP)))
-		netdev_err(netdev, "Failed initializing PHC, error: %d\n", rc);
+	/* On probe PHC is initialized by ena_complete_deferred_init() */
+	if (!test_bit(ENA_FLAG_DEFERRED_INIT, &adapter->flags)) {
+		rc = ena_phc_init(adapter);
+		if (unlikely(rc && (rc != -EOPNOTSUPP)))
+			netdev_err(netdev, "Failed initializing PHC, error: %d\n", rc);
+	}
 
 	rc = ena_com_get_hw_timestamping_support(ena_dev, &adapter->hw_ts_state.hw_tx_supported,
 						 &adapter->hw_ts_state.hw_rx_supported);
@@ -4619,6 +5575,9 @@ int ena_restore_device(struct ena_adapter *adapter)
 	mod_timer(&adapter->timer_service, round_jiffies(jiffies + HZ));
 	adapter->last_keep_alive_jiffies = jiffies;
 
+	/* In case the device was reset before the deferred init work ran */
+	ena_complete_deferred_init(adapter);
+
 	return rc;
 err_disable_msix:
 	ena_free_mgmnt_irq(adapter);
@@ -4641,14 +5600,12 @@ err:
 	return rc;
 }
 
-static void ena_fw_reset_device(struct work_struct *work)
+/* Must be called with rtnl lock held */
+int ena_handle_reset_trigger(struct ena_adapter *adapter)
 {
 	int rc = 0;
 
-	struct ena_adapter *adapter =
-		container_of(work, struct ena_adapter, reset_task);
-
-	rtnl_lock();
+	ASSERT_RTNL();
 
 	if (likely(test_bit(ENA_FLAG_TRIGGER_RESET, &adapter->flags))) {
 		netif_err(adapter, drv, adapter->netdev, "Trigger reset is on\n");
@@ -4671,6 +5628,23 @@ static void ena_fw_reset_device(struct work_struct *work)
 			rc, driver_info);
 	}
 
+	return rc;
+}
+
+static void ena_fw_reset_device(struct work_struct *work)
+{
+	struct ena_adapter *adapter =
+		container_of(work, struct ena_adapter, reset_task);
+
+	/* Let the devlink health reporter matching the reset reason record
+	 * the event and, if auto recovery is enabled, perform the reset.
+	 * Otherwise fall back to resetting the device directly.
+	 */
+	if (ena_devlink_health_report(adapter))
+		return;
+
+	rtnl_lock();
+	ena_handle_reset_trigger(adapter);
 	rtnl_unlock();
 }
 
@@ -4679,7 +5653,8 @@ static int check_for_rx_interrupt_queue(struct ena_adapter *adapter,
 {
 	struct ena_napi *ena_napi = container_of(rx_ring->napi, struct ena_napi, napi);
 
-	if (likely(READ_ONCE(ena_napi->last_intr_jiffies) != 0))
+	/* Poll mode queues don't receive interrupts */
+	if (likely(READ_ONCE(ena_napi->last_intr_jiffies) != 0) || ena_napi->poll_mode)
 		return 0;
 
 	if (ena_com_rx_cq_empty(rx_ring->ena_com_io_cq))
@@ -4776,6 +5751,32 @@ static void check_pending_pkts_in_txsq(struct ena_ring *tx_ring,
 	atomic64_add(*new_missed_tx, &tx_ring->tx_stats.pending_timedout_pkts);
 }
 
+/* Find the start of the send time epoch of the oldest pending packet of the
+ * ring. The returned time is never later than the real send time of that
+ * packet, so it can be used to rule out expired packets without scanning.
+ *
+ * @return: true if the ring has pending packets
+ */
+static bool ena_tx_oldest_pending_jiffies(struct ena_ring *tx_ring,
+					  unsigned long *oldest)
+{
+	struct ena_tx_pending_tracker *tracker = &tx_ring->pending_tracker;
+	unsigned long now_epoch = jiffies / ENA_TX_PENDING_EPOCH_JIFFIES;
+	unsigned long epoch;
+	u32 idx;
+
+	for (epoch = now_epoch - (ENA_TX_PENDING_EPOCHS - 1);
+	     epoch != now_epoch + 1; epoch++) {
+		idx = epoch & (ENA_TX_PENDING_EPOCHS - 1);
+		if (READ_ONCE(tracker->sent[idx]) != READ_ONCE(tracker->completed[idx])) {
+			*oldest = epoch * ENA_TX_PENDING_EPOCH_JIFFIES;
+			return true;
+		}
+	}
+
+	return false;
+}
+
 static int check_missing_comp_in_tx_queue(struct ena_adapter *adapter, struct ena_ring *tx_ring)
 {
 	unsigned long miss_tx_comp_to_jiffies = adapter->missing_tx_completion_to_jiffies;
@@ -4789,8 +5790,23 @@ static int check_missing_comp_in_tx_queue(struct ena_adapter *adapter, struct en
 	struct net_device *netdev = adapter->netdev;
 	int napi_sched_changes = 0, rc = 0;
 	struct ena_tx_buffer *tx_buf;
+	unsigned long oldest_pending;
 	u32 new_missed_tx = 0;
 
+	/* Scan the ring only if its oldest pending packet may have expired.
+	 * Packets pending for longer than the tracked epochs window alias onto
+	 * recent epochs, so the shortcut is used only if the window covers the
+	 * graceful timeout (twice the timeout) as well.
+	 */
+	if (2 * miss_tx_comp_to_jiffies <
+	    (ENA_TX_PENDING_EPOCHS - 1) * ENA_TX_PENDING_EPOCH_JIFFIES) {
+		if (!ena_tx_oldest_pending_jiffies(tx_ring, &oldest_pending))
+			return 0;
+
+		if (time_is_after_eq_jiffies(oldest_pending + miss_tx_comp_to_jiffies))
+			return 0;
+	}
+
 	/* Read the initial napi sched state and compare during the loop */
 	napi_scheduled = !!(READ_ONCE(ena_napi->napi.state) & NAPIF_STATE_SCHED);
 
@@ -4805,7 +5821,8 @@ static int check_missing_comp_in_tx_queue(struct ena_adapter *adapter, struct en
 
 		/* Checking if current TX ring didn't get first interrupt */
 		is_expired = time_is_before_jiffies(graceful_timeout);
-		if (unlikely(READ_ONCE(ena_napi->last_intr_jiffies) == 0 && is_expired)) {
+		if (unlikely(READ_ONCE(ena_napi->last_intr_jiffies) == 0 && is_expired &&
+			     !ena_napi->poll_mode)) {
 			/* If first interrupt is still not received, schedule a reset */
 			netif_err(adapter, tx_err, netdev,
 				  "Potential MSIX issue on Tx side Queue = %d.\n",
@@ -4941,7 +5958,7 @@ static void check_for_missing_completions(struct ena_adapter *adapter)
 {
 	struct ena_ring *tx_ring;
 	struct ena_ring *rx_ring;
-	int qid, budget, rc;
+	int qid, rc;
 
 	/* Make sure the driver doesn't turn the device in other process */
 	smp_rmb();
@@ -4955,13 +5972,7 @@ static void check_for_missing_completions(struct ena_adapter *adapter)
 	if (adapter->missing_tx_completion_to_jiffies == ENA_HW_HINTS_NO_TIMEOUT)
 		return;
 
-	budget = min_t(u32, adapter->num_io_queues, ENA_MONITORED_QUEUES);
-
-	qid = adapter->last_monitored_qid;
-
-	while (budget) {
-		qid = (qid + 1) % adapter->num_io_queues;
-
+	for (qid = 0; qid < adapter->num_io_queues; qid++) {
 		tx_ring = &adapter->tx_ring[qid];
 		rx_ring = &adapter->rx_ring[qid];
 
@@ -4972,11 +5983,7 @@ static void check_for_missing_completions(struct ena_adapter *adapter)
 		rc = check_for_rx_interrupt_queue(adapter, rx_ring);
 		if (unlikely(rc))
 			return;
-
-		budget--;
 	}
-
-	adapter->last_monitored_qid = qid;
 }
 
 /* trigger napi schedule after 2 consecutive detections */
@@ -5162,7 +6169,8 @@ static void check_for_lost_interrupts(struct ena_adapter *adapter)
 		 *    previous check for either rx or tx rings
 		 * 3. The last_napi_jiffies hasn't changed since the last check
 		 */
-		if (!!(READ_ONCE(ena_napi->napi.state) & NAPIF_STATE_SCHED)) {
+		if (ena_napi->poll_mode ||
+		    !!(READ_ONCE(ena_napi->napi.state) & NAPIF_STATE_SCHED)) {
 			/* Reset indication of handled lost interrupt
 			 * once ring is back to healthy state
 			 */
@@ -5316,6 +6324,16 @@ static void ena_set_dev_offloads(struct ena_com_dev_get_features_ctx *feat,
 	if (feat->offload.tx & ENA_ADMIN_FEATURE_OFFLOAD_DESC_TSO_ECN_MASK)
 		dev_features |= NETIF_F_TSO_ECN;
 
+#ifdef ENA_UDP_GSO_SUPPORT
+	/* UDP GSO packets are segmented by the driver, using the device's
+	 * L4 checksum offload for each segment
+	 */
+	if ((dev_features & (NETIF_F_IP_CSUM | NETIF_F_IPV6_CSUM)) &&
+	    adapter->ena_dev->tx_mem_queue_type == ENA_ADMIN_PLACEMENT_POLICY_DEV)
+		dev_features |= NETIF_F_GSO_UDP_L4;
+
+#endif /* ENA_UDP_GSO_SUPPORT */
+
 	if (feat->offload.rx_supported &
 		ENA_ADMIN_FEATURE_OFFLOAD_DESC_RX_L4_IPV4_CSUM_MASK)
 		dev_features |= NETIF_F_RXCSUM;
@@ -5462,6 +6480,46 @@ err_allocation:
 	netdev_err(adapter->netdev, "Cannot allocate stats buffers\n");
 }
 
+/* Initialization which isn't required for registering the netdev. It is
+ * deferred from probe, so that multiple adapters can probe in parallel, and
+ * is completed by the deferred init work, or earlier by any flow which
+ * depends on it. Must be called with rtnl lock held.
+ */
+void ena_complete_deferred_init(struct ena_adapter *adapter)
+{
+	struct net_device *netdev = adapter->netdev;
+	int rc;
+
+	ASSERT_RTNL();
+
+	/* If the device is being reset, the deferred init is completed once
+	 * it is restored
+	 */
+	if (likely(!test_bit(ENA_FLAG_DEFERRED_INIT, &adapter->flags)) ||
+	    !test_bit(ENA_FLAG_DEVICE_RUNNING, &adapter->flags))
+		return;
+
+	clear_bit(ENA_FLAG_DEFERRED_INIT, &adapter->flags);
+
+	rc = ena_phc_init(adapter);
+	if (unlikely(rc && (rc != -EOPNOTSUPP)))
+		netdev_err(netdev, "Failed initializing PHC, error: %d\n", rc);
+
+	ena_config_debug_area(adapter);
+
+	ena_alloc_stats_buffers(adapter);
+}
+
+static void ena_deferred_init_work(struct work_struct *work)
+{
+	struct ena_adapter *adapter =
+		container_of(work, struct ena_adapter, deferred_init_task);
+
+	rtnl_lock();
+	ena_complete_deferred_init(adapter);
+	rtnl_unlock();
+}
+
 /* ena_probe - Device Initialization Routine
  * @pdev: PCI device information struct
  * @ent: entry in ena_pci_tbl
@@ -5478,7 +6536,7 @@ static int ena_probe(struct pci_dev *pdev, const struct pci_device_id *ent)
 	struct ena_com_dev *ena_dev = NULL;
 	struct ena_adapter *adapter;
 	struct net_device *netdev;
-	static int adapters_found;
+	static atomic_t adapters_found = ATOMIC_INIT(0);
 	struct devlink *devlink;
 	u32 max_num_io_queues;
 	bool wd_state;
@@ -5572,8 +6630,20 @@ static int ena_probe(struct pci_dev *pdev, const struct pci_device_id *ent)
 
 	ena_set_forced_llq_size_policy(adapter);
 
+	if (ena_set_irq_policy(adapter, irq_policy, irq_cpu_list))
+		dev_warn(&pdev->dev, "Using the default IRQ placement policy\n");
+
+	if (poll_mode_queues &&
+	    bitmap_parselist(poll_mode_queues, adapter->poll_mode_queues,
+			     ENA_MAX_NUM_IO_QUEUES)) {
+		dev_warn(&pdev->dev, "Invalid poll mode queues list %s\n", poll_mode_queues);
+		bitmap_zero(adapter->poll_mode_queues, ENA_MAX_NUM_IO_QUEUES);
+	}
+	adapter->poll_idle_backoff_us = poll_idle_backoff_us;
+
 #ifdef ENA_PHC_SUPPORT
 	ena_phc_enable(adapter, !!phc_enable);
+	ena_phc_set_cache_interval(adapter, phc_cache_ms);
 
 #endif /* ENA_PHC_SUPPORT */
 	rc = ena_com_allocate_customer_metrics_buffer(ena_dev);
@@ -5588,6 +6658,11 @@ static int ena_probe(struct pci_dev *pdev, const struct pci_device_id *ent)
 		goto err_metrics_destroy;
 	}
 
+	/* PHC, debug area and stats buffers are initialized after the
+	 * netdev is registered, see ena_complete_deferred_init()
+	 */
+	set_bit(ENA_FLAG_DEFERRED_INIT, &adapter->flags);
+
 	/* Need to do this before ena_device_init */
 	devlink = ena_devlink_alloc(adapter);
 	if (!devlink) {
@@ -5638,7 +6713,6 @@ static int ena_probe(struct pci_dev *pdev, const struct pci_device_id *ent)
 
 #endif /* ENA_LPC_SUPPORT */
 	adapter->max_num_io_queues = max_num_io_queues;
-	adapter->last_monitored_qid = 0;
 
 	adapter->rx_copybreak = ENA_DEFAULT_RX_COPYBREAK;
 	if (likely(ena_dev->tx_mem_queue_type == ENA_ADMIN_PLACEMENT_POLICY_DEV))
@@ -5648,8 +6722,6 @@ static int ena_probe(struct pci_dev *pdev, const struct pci_device_id *ent)
 
 	adapter->wd_state = wd_state;
 
-	snprintf(adapter->name, ENA_NAME_MAX_LEN, "ena_%d", adapters_found);
-
 	rc = ena_com_init_interrupt_moderation(adapter->ena_dev);
 	if (rc) {
 		dev_err(&pdev->dev,
@@ -5666,6 +6738,10 @@ static int ena_probe(struct pci_dev *pdev, const struct pci_device_id *ent)
 	/* Init all potential io rings */
 	ena_init_io_rings(adapter, adapter->max_num_io_queues);
 
+	rc = ena_flight_recorder_alloc(adapter);
+	if (unlikely(rc))
+		dev_warn(&pdev->dev, "Failed to allocate flight recorders\n");
+
 	netdev->netdev_ops = &ena_netdev_ops;
 #ifdef ENA_HAVE_NETDEV_QUEUE_STATS
 	netdev->stat_ops = &ena_stat_ops;
@@ -5730,13 +6806,10 @@ static int ena_probe(struct pci_dev *pdev, const struct pci_device_id *ent)
 		goto err_flow_steering;
 	}
 
-	ena_config_debug_area(adapter);
-
-	ena_alloc_stats_buffers(adapter);
-
 	ena_debugfs_init(netdev);
 
 	INIT_WORK(&adapter->reset_task, ena_fw_reset_device);
+	INIT_WORK(&adapter->deferred_init_task, ena_deferred_init_work);
 
 	adapter->last_keep_alive_jiffies = jiffies;
 	adapter->keep_alive_timeout = ENA_DEVICE_KALIVE_TIMEOUT;
@@ -5758,9 +6831,13 @@ static int ena_probe(struct pci_dev *pdev, const struct pci_device_id *ent)
 		 DEVICE_NAME, (long)pci_resource_start(pdev, 0),
 		 netdev->dev_addr);
 
+	/* Taken after the last failure point, so failed probes leave no gaps */
+	snprintf(adapter->name, ENA_NAME_MAX_LEN, "ena_%d",
+		 atomic_inc_return(&adapters_found) - 1);
+
 	set_bit(ENA_FLAG_DEVICE_RUNNING, &adapter->flags);
 
-	adapters_found++;
+	queue_work(ena_wq, &adapter->deferred_init_task);
 
 	/* From this point, the devlink device is visible to users.
 	 * Perform the registration last to ensure that all the resources
@@ -5783,6 +6860,7 @@ err_free_msix:
 	ena_free_mgmnt_irq(adapter);
 	ena_disable_msix(adapter);
 err_worker_destroy:
+	ena_flight_recorder_free(adapter);
 #ifdef ENA_HAVE_DEL_TIMER
 	del_timer(&adapter->timer_service);
 #else
@@ -5848,6 +6926,7 @@ static void __ena_shutoff(struct pci_dev *pdev, bool shutdown)
 	timer_delete_sync(&adapter->timer_service);
 #endif /* ENA_HAVE_DEL_TIMER */
 	cancel_work_sync(&adapter->reset_task);
+	cancel_work_sync(&adapter->deferred_init_task);
 
 	rtnl_lock(); /* lock released inside the below if-else block */
 	ena_set_reset_reason(adapter, ENA_REGS_RESET_SHUTDOWN);
@@ -5876,6 +6955,8 @@ static void __ena_shutoff(struct pci_dev *pdev, bool shutdown)
 
 	ena_com_delete_debug_area(ena_dev);
 
+	ena_flight_recorder_free(adapter);
+
 	ena_free_stats_buffers(adapter);
 
 	ena_com_delete_host_info(ena_dev);
@@ -5982,6 +7063,9 @@ static struct pci_driver ena_pci_driver = {
 	.probe		= ena_probe,
 	.remove		= ena_remove,
 	.shutdown	= ena_shutdown,
+#ifdef ENA_HAVE_PROBE_PREFER_ASYNCHRONOUS
+	.driver.probe_type = PROBE_PREFER_ASYNCHRONOUS,
+#endif /* ENA_HAVE_PROBE_PREFER_ASYNCHRONOUS */
 #ifdef ENA_GENERIC_PM_OPS
 	.driver.pm	= &ena_pm_ops,
 #else /* ENA_GENERIC_PM_OPS */
@@ -37,6 +37,7 @@
 #include "ena_com.h"
 #include "ena_eth_com.h"
 #include "ena_debug.h"
+#include "ena_trace.h"
 
 #define DRV_MODULE_GEN_MAJOR	2
 #define DRV_MODULE_GEN_MINOR	17
@@ -96,14 +97,27 @@
  */
 #define ENA_TX_POLL_BUDGET_DIVIDER	4
 
+/* When Tx completions reaping from the transmit path is enabled, it is done
+ * once less than ring_size / ENA_TX_REAP_THRESH_DIVIDER descriptors are free.
+ */
+#define ENA_TX_REAP_THRESH_DIVIDER	4
+
+/* A deferred Tx doorbell is written once this many bytes are pending */
+#define ENA_TX_DB_COALESCE_MAX_BYTES	(64 * 1024)
+/* Upper bound of tx_db_coalesce_usecs, also keeps it in nsecs within a u32 */
+#define ENA_TX_DB_COALESCE_MAX_USECS	1000
+
+/* UDP GSO packets are segmented by the driver only if all of their segments
+ * fit in ring_size / ENA_UDP_GSO_RING_DIVIDER LLQ entries.
+ */
+#define ENA_UDP_GSO_RING_DIVIDER	2
+
 /* Refill Rx queue when number of required descriptors is above
  * QUEUE_SIZE / ENA_RX_REFILL_THRESH_DIVIDER or ENA_RX_REFILL_THRESH_PACKET
  */
 #define ENA_RX_REFILL_THRESH_DIVIDER	8
 #define ENA_RX_REFILL_THRESH_PACKET	256
 
-/* Number of queues to check for missing completions / interrupts per timer service */
-#define ENA_MONITORED_QUEUES	4
 /* Max timeout packets before device reset */
 #define MAX_NUM_OF_TIMEOUTED_PACKETS 128
 
@@ -158,6 +172,13 @@ struct ena_napi {
 	struct ena_ring *rx_ring;
 	u32 qid;
 	struct dim dim;
+	/* Interrupts stay masked and NAPI keeps polling the queue */
+	bool poll_mode;
+	/* Time NAPI waits before polling an idle queue again in poll mode */
+	u32 poll_idle_backoff_ns;
+	struct hrtimer poll_timer;
+	/* Schedules NAPI to write the deferred Tx doorbell */
+	struct hrtimer tx_db_timer;
 };
 
 #ifdef ENA_XDP_SUPPORT
@@ -174,15 +195,15 @@ struct ena_tx_buffer {
 	/* XDP buffer structure which is used for sending packets */
 	struct xdp_frame *xdpf;
 #endif /* ENA_XDP_SUPPORT */
+	/* Total size of all buffers in bytes */
+	u32 total_tx_size;
+
 	/* num of ena desc for this specific skb
 	 * (includes data desc and metadata desc)
 	 */
-	u32 tx_descs;
+	u16 tx_descs;
 	/* num of buffers used by this skb */
-	u32 num_of_bufs;
-
-	/* Total size of all buffers in bytes */
-	u32 total_tx_size;
+	u8 num_of_bufs;
 
 	/* Indicate if bufs[0] map the linear data of the skb. */
 	u8 map_linear_data;
@@ -227,19 +248,62 @@ struct ena_rx_buffer {
 	struct page *page;
 	dma_addr_t dma_addr;
 #endif /* ENA_AF_XDP_SUPPORT */
-	u32 page_offset;
-	u32 buf_offset;
 	struct ena_com_buf ena_buf;
-#ifdef ENA_LPC_SUPPORT
-	bool is_lpc_page;
-#endif /* ENA_LPC_SUPPORT */
 #ifdef ENA_PAGE_POOL_SUPPORT
 	/* Used to locally frag a page allocated from page pool via the DRB
 	 * mechanism, thus avoiding atomic ops to update the page ref.
 	 */
 	long pagecnt_bias;
 #endif /* ENA_PAGE_POOL_SUPPORT */
-} ____cacheline_aligned;
+	/* Both offsets are bounded by ENA_PAGE_SIZE (at most 16kB) */
+	u16 page_offset;
+	u16 buf_offset;
+#ifdef ENA_LPC_SUPPORT
+	bool is_lpc_page;
+#endif /* ENA_LPC_SUPPORT */
+};
+
+/* Number of buckets in the Tx latency histograms. Bucket 0 counts samples
+ * below 1 usec, bucket i counts samples in [2^(i-1), 2^i) usec and the last
+ * bucket also absorbs everything above it.
+ */
+#define ENA_TX_LAT_HIST_BUCKETS	16
+
+enum ena_tx_lat_sample_state {
+	ENA_TX_LAT_SAMPLE_IDLE,
+	ENA_TX_LAT_SAMPLE_QUEUED,
+	ENA_TX_LAT_SAMPLE_IN_FLIGHT,
+};
+
+/* Tracks at most one sampled packet per Tx ring at a time. The packet is
+ * stamped when it is queued in ena_xmit_common(), when its doorbell is
+ * written and when its completion is processed.
+ */
+struct ena_tx_lat_sampler {
+	u64 xmit_ns;
+	u64 doorbell_ns;
+	u32 pkts_since_sample;
+	u16 req_id;
+	u8 state;
+	/* Time from queueing the packet until its doorbell */
+	u64 driver_hist[ENA_TX_LAT_HIST_BUCKETS];
+	/* Time from the doorbell until the Tx completion is processed */
+	u64 device_hist[ENA_TX_LAT_HIST_BUCKETS];
+};
+
+/* Pending Tx packets are counted per send time epoch, so the timer service
+ * can find the epoch of the oldest pending packet of a ring without scanning
+ * its buffers. Must be a power of 2.
+ */
+#define ENA_TX_PENDING_EPOCHS		32
+#define ENA_TX_PENDING_EPOCH_JIFFIES	(HZ / 2)
+
+struct ena_tx_pending_tracker {
+	/* Updated by the xmit path only */
+	u32 sent[ENA_TX_PENDING_EPOCHS] ____cacheline_aligned;
+	/* Updated by the Tx completion path only */
+	u32 completed[ENA_TX_PENDING_EPOCHS] ____cacheline_aligned;
+};
 
 struct ena_stats_tx {
 	u64 cnt;
@@ -260,6 +324,22 @@ struct ena_stats_tx {
 	u64 unmask_interrupt;
 	u64 last_napi_jiffies;
 	u64 lost_interrupt;
+	u64 metadata_bytes;
+	u64 xmit_reap;
+	u64 doorbells_deferred;
+	/* UDP GSO packets segmented by the driver */
+	u64 udp_gso;
+	/* Histogram of the Tx packets' headers length, up to the end of
+	 * the (inner) L4 header
+	 */
+	u64 hdr_len_64;
+	u64 hdr_len_96;
+	u64 hdr_len_128;
+	u64 hdr_len_160;
+	u64 hdr_len_224;
+	u64 hdr_len_above_224;
+	/* Packets whose headers don't fit in the LLQ header */
+	u64 hdr_len_above_llq;
 #ifdef ENA_AF_XDP_SUPPORT
 	u64 xsk_cnt;
 	u64 xsk_bytes;
@@ -294,6 +374,7 @@ struct ena_stats_rx {
 	u64 bad_req_id;
 	u64 empty_rx_ring;
 	u64 csum_unchecked;
+	u64 metadata_bytes;
 #ifdef ENA_XDP_SUPPORT
 	u64 xdp_aborted;
 	u64 xdp_drop;
@@ -378,6 +459,18 @@ struct ena_ring {
 	u16 sgl_size;
 	u8 enable_bql;
 
+	/* Max Tx completions cleaned by ena_start_xmit(), 0 if disabled */
+	u16 xmit_reap_budget;
+	/* Serializes Tx completions cleanup when xmit_reap_budget is set */
+	spinlock_t tx_clean_lock;
+
+	/* Tx doorbell coalescing, disabled if tx_db_coalesce_pkts is 0 */
+	u16 tx_db_coalesce_pkts;
+	u32 tx_db_coalesce_ns;
+	/* Packets and bytes queued since the last doorbell */
+	u32 tx_db_pending_pkts;
+	u32 tx_db_pending_bytes;
+
 	/* The maximum header length the device can handle */
 	u8 tx_max_header_size;
 
@@ -406,6 +499,9 @@ struct ena_ring {
 
 	u8 *push_buf_intermediate_buf;
 	int empty_rx_queue;
+	struct ena_tx_lat_sampler lat_sampler;
+	struct ena_tx_pending_tracker pending_tracker;
+	struct ena_flight_recorder *flight_recorder;
 #ifdef ENA_BUSY_POLL_SUPPORT
 	atomic_t bp_state;
 #endif
@@ -459,7 +555,8 @@ enum ena_flags_t {
 	ENA_FLAG_LINK_UP,
 	ENA_FLAG_MSIX_ENABLED,
 	ENA_FLAG_TRIGGER_RESET,
-	ENA_FLAG_ONGOING_RESET
+	ENA_FLAG_ONGOING_RESET,
+	ENA_FLAG_DEFERRED_INIT
 };
 
 enum ena_llq_header_size_policy_t {
@@ -481,6 +578,8 @@ struct hw_timestamp_state {
 
 struct ena_debug_area_info {
 	struct ena_reset_reason_debug_info *reset_info;
+	/* Tx rings' recorders followed by Rx rings' recorders */
+	struct ena_flight_recorder *flight_recorders;
 	u16 offending_qid;
 };
 
@@ -491,6 +590,21 @@ struct ena_stats_buffers {
 	u64 *queue_data_buf;
 };
 
+/* IO IRQs placement policies. Every policy other than ENA_IRQ_POLICY_LOCAL
+ * pins each IO IRQ to a single CPU and sets the XPS maps of its queue to match.
+ */
+enum ena_irq_policy {
+	/* Spread over the CPUs of the device's NUMA node */
+	ENA_IRQ_POLICY_LOCAL,
+	/* A single hardware thread of every physical core, housekeeping CPUs only */
+	ENA_IRQ_POLICY_PHYS_CORES,
+	/* Housekeeping CPUs only */
+	ENA_IRQ_POLICY_HOUSEKEEPING,
+	/* CPUs in a user provided list */
+	ENA_IRQ_POLICY_CPU_LIST,
+	ENA_IRQ_POLICY_MAX
+};
+
 /* adapter specific private data structure */
 struct ena_adapter {
 	struct ena_com_dev *ena_dev;
@@ -529,13 +643,32 @@ struct ena_adapter {
 
 	u32 msg_enable;
 
+	enum ena_irq_policy irq_policy;
+	cpumask_t irq_cpu_list;
+	/* XPS maps were installed according to the IRQ policy */
+	bool xps_maps_set;
+
+	/* IO queues handled in poll mode */
+	DECLARE_BITMAP(poll_mode_queues, ENA_MAX_NUM_IO_QUEUES);
+	u32 poll_idle_backoff_us;
+#ifdef ENA_HAVE_THREADED_NAPI
+	/* Threaded NAPI was enabled by the driver for the poll mode queues */
+	bool poll_mode_threaded_napi;
+#endif /* ENA_HAVE_THREADED_NAPI */
+
 	/* The policy is used for two purposes:
 	 * 1. Indicates who decided on LLQ entry size (user / device)
 	 * 2. Indicates whether large LLQ is set or not after device
 	 *    initialization / configuration.
 	 */
 	enum ena_llq_header_size_policy_t llq_policy;
+	/* The policy applied when the LLQ entry size is left to the device */
+	enum ena_llq_header_size_policy_t llq_default_policy;
 	bool large_llq_header_supported;
+	/* Choose the LLQ header size on device reset according to the
+	 * observed Tx headers length
+	 */
+	bool large_llq_auto;
 
 	u16 max_tx_sgl_size;
 	u16 max_rx_sgl_size;
@@ -569,6 +702,7 @@ struct ena_adapter {
 
 	/* timer service */
 	struct work_struct reset_task;
+	struct work_struct deferred_init_task;
 	struct timer_list timer_service;
 
 	bool wd_state;
@@ -579,9 +713,6 @@ struct ena_adapter {
 	struct u64_stats_sync syncp;
 	struct ena_stats_dev dev_stats;
 
-	/* last queue index that was checked for missing completions / interrupts */
-	u32 last_monitored_qid;
-
 	atomic_t reset_reason;
 
 #ifdef ENA_XDP_SUPPORT
@@ -594,11 +725,18 @@ struct ena_adapter {
 	struct devlink *devlink;
 #ifdef ENA_DEVLINK_SUPPORT
 	struct devlink_port devlink_port;
+	struct devlink_health_reporter *tx_timeout_reporter;
+	struct devlink_health_reporter *tx_comp_reporter;
+	struct devlink_health_reporter *keep_alive_reporter;
+	struct devlink_health_reporter *admin_reporter;
+	struct devlink_health_reporter *fr_reporter;
 #endif /* ENA_DEVLINK_SUPPORT */
 #ifdef CONFIG_DEBUG_FS
 
 	struct dentry *debugfs_base;
 #endif /* CONFIG_DEBUG_FS */
+	/* Sample one in every tx_lat_sample_interval Tx packets, 0 disables */
+	u32 tx_lat_sample_interval;
 
 	struct ena_debug_area_info debug_area_info;
 };
@@ -670,6 +808,14 @@ static inline void ena_increase_stat(u64 *statp, u64 cnt,
 	u64_stats_update_end(syncp);
 }
 
+static inline void ena_set_stat(u64 *statp, u64 val,
+				struct u64_stats_sync *syncp)
+{
+	u64_stats_update_begin(syncp);
+	(*statp) = val;
+	u64_stats_update_end(syncp);
+}
+
 static inline void ena_update_tx_stats(struct ena_ring *tx_ring,
 				       u64 packets, u64 bytes)
 {
@@ -856,16 +1002,123 @@ struct page *ena_alloc_map_page(struct ena_ring *rx_ring, dma_addr_t *dma);
 #endif /* ENA_LPC_SUPPORT */
 int ena_destroy_device(struct ena_adapter *adapter, bool graceful);
 int ena_restore_device(struct ena_adapter *adapter);
+int ena_handle_reset_trigger(struct ena_adapter *adapter);
+void ena_complete_deferred_init(struct ena_adapter *adapter);
+int ena_set_irq_policy(struct ena_adapter *adapter, u32 policy, const char *cpu_list);
+enum ena_llq_header_size_policy_t ena_large_llq_recommendation(struct ena_adapter *adapter);
+void ena_apply_large_llq_recommendation(struct ena_adapter *adapter);
 void ena_get_and_dump_head_tx_cdesc(struct ena_com_io_cq *io_cq);
 void ena_get_and_dump_head_rx_cdesc(struct ena_com_io_cq *io_cq);
 int handle_invalid_req_id(struct ena_ring *ring, u16 req_id,
 			  struct ena_tx_buffer *tx_info);
 int validate_tx_req_id(struct ena_ring *tx_ring, u16 req_id);
 
+static inline u32 ena_tx_lat_bucket(u64 delta_ns)
+{
+	u64 usecs = div_u64(delta_ns, NSEC_PER_USEC);
+
+	if (!usecs)
+		return 0;
+
+	return min_t(u32, ilog2(usecs) + 1, ENA_TX_LAT_HIST_BUCKETS - 1);
+}
+
+/* ena_tx_lat_sample_xmit - Arm the Tx latency sampler for a queued packet
+ * @tx_ring: Tx ring the packet was queued on
+ * @req_id: request id of the queued packet
+ *
+ * Must be called under the Tx queue lock after the packet descriptors
+ * were written to the submission queue.
+ */
+static inline void ena_tx_lat_sample_xmit(struct ena_ring *tx_ring, u16 req_id)
+{
+	struct ena_tx_lat_sampler *sampler = &tx_ring->lat_sampler;
+	u32 interval = READ_ONCE(tx_ring->adapter->tx_lat_sample_interval);
+
+	if (likely(!interval))
+		return;
+
+	if (++sampler->pkts_since_sample < interval ||
+	    smp_load_acquire(&sampler->state) != ENA_TX_LAT_SAMPLE_IDLE)
+		return;
+
+	sampler->pkts_since_sample = 0;
+	sampler->req_id = req_id;
+	sampler->xmit_ns = ktime_get_ns();
+	/* Publish req_id and xmit_ns before the sample is seen as queued */
+	smp_store_release(&sampler->state, ENA_TX_LAT_SAMPLE_QUEUED);
+}
+
+static inline void ena_tx_lat_sample_doorbell(struct ena_ring *tx_ring)
+{
+	struct ena_tx_lat_sampler *sampler = &tx_ring->lat_sampler;
+	u64 now;
+
+	if (likely(smp_load_acquire(&sampler->state) != ENA_TX_LAT_SAMPLE_QUEUED))
+		return;
+
+	now = ktime_get_ns();
+	sampler->doorbell_ns = now;
+	sampler->driver_hist[ena_tx_lat_bucket(now - sampler->xmit_ns)]++;
+	/* Publish doorbell_ns before the completion path may consume it */
+	smp_store_release(&sampler->state, ENA_TX_LAT_SAMPLE_IN_FLIGHT);
+}
+
+/* ena_tx_lat_sample_complete - Account a completed Tx packet in the sampler
+ * @tx_ring: Tx ring the completion arrived on
+ * @req_id: request id of the completed packet
+ *
+ * Called from the Tx completion path for every completed packet.
+ */
+static inline void ena_tx_lat_sample_complete(struct ena_ring *tx_ring,
+					      u16 req_id)
+{
+	struct ena_tx_lat_sampler *sampler = &tx_ring->lat_sampler;
+	u8 state = smp_load_acquire(&sampler->state);
+
+	if (likely(state == ENA_TX_LAT_SAMPLE_IDLE) || sampler->req_id != req_id)
+		return;
+
+	if (state == ENA_TX_LAT_SAMPLE_IN_FLIGHT)
+		sampler->device_hist[ena_tx_lat_bucket(ktime_get_ns() -
+						       sampler->doorbell_ns)]++;
+
+	smp_store_release(&sampler->state, ENA_TX_LAT_SAMPLE_IDLE);
+}
+
+static inline u32 ena_tx_pending_epoch_idx(unsigned long sent_jiffies)
+{
+	return (sent_jiffies / ENA_TX_PENDING_EPOCH_JIFFIES) &
+	       (ENA_TX_PENDING_EPOCHS - 1);
+}
+
+static inline void ena_tx_pending_sent(struct ena_ring *tx_ring,
+				       unsigned long sent_jiffies)
+{
+	u32 *cnt = &tx_ring->pending_tracker.sent[ena_tx_pending_epoch_idx(sent_jiffies)];
+
+	WRITE_ONCE(*cnt, *cnt + 1);
+}
+
+static inline void ena_tx_pending_completed(struct ena_ring *tx_ring,
+					    unsigned long sent_jiffies)
+{
+	u32 *cnt = &tx_ring->pending_tracker.completed[ena_tx_pending_epoch_idx(sent_jiffies)];
+
+	WRITE_ONCE(*cnt, *cnt + 1);
+}
+
 static inline void ena_ring_tx_doorbell(struct ena_ring *tx_ring)
 {
 	ena_com_write_tx_sq_doorbell(tx_ring->ena_com_io_sq);
+	WRITE_ONCE(tx_ring->tx_db_pending_pkts, 0);
+	tx_ring->tx_db_pending_bytes = 0;
 	ena_increase_stat(&tx_ring->tx_stats.doorbells, 1, &tx_ring->syncp);
+	ena_tx_lat_sample_doorbell(tx_ring);
+	ena_fr_record(tx_ring->flight_recorder, ENA_FR_EVENT_TX_DOORBELL,
+		      tx_ring->next_to_use, (u32)tx_ring->tx_stats.doorbells);
+	trace_ena_tx_doorbell(tx_ring->netdev->ifindex, tx_ring->qid,
+			      tx_ring->next_to_use);
 }
 
 int ena_xmit_common(struct ena_adapter *adapter,
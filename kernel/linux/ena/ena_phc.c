@@ -35,6 +35,175 @@ static int ena_phc_feature_enable(struct ptp_clock_info *clock_info,
 	return -EOPNOTSUPP;
 }
 
+static bool ena_phc_cache_enabled(struct ena_phc_info *phc_info)
+{
+	return phc_info->cache_interval_ms != 0;
+}
+
+/* Interpolate the current PHC time and its error bound from the cached
+ * sample, fails if there is no valid sample or it is too old to be used.
+ * Lock-free, may be called concurrently from any number of readers.
+ */
+static int ena_phc_cache_get(struct ena_phc_info *phc_info,
+			     u64 *timestamp,
+			     u32 *error_bound)
+{
+	struct ena_phc_cache *cache = &phc_info->cache;
+	u64 phc_ns, sys_ns, elapsed_ns, max_age_ns, ts_ns;
+	u32 sample_err_ns, drift_err_ppb;
+	s64 last_ns, prev_ns;
+	unsigned int seq;
+	s32 drift_ppb;
+	bool valid;
+
+	if (!ena_phc_cache_enabled(phc_info))
+		return -EOPNOTSUPP;
+
+	do {
+		seq = read_seqbegin(&cache->lock);
+		valid = cache->valid;
+		phc_ns = cache->phc_ns;
+		sys_ns = cache->sys_ns;
+		sample_err_ns = cache->sample_err_ns;
+		drift_ppb = cache->drift_ppb;
+		drift_err_ppb = cache->drift_err_ppb;
+	} while (read_seqretry(&cache->lock, seq));
+
+	if (!valid)
+		return -EAGAIN;
+
+	elapsed_ns = ktime_get_raw_ns() - sys_ns;
+	max_age_ns = (u64)phc_info->cache_interval_ms *
+		     ENA_PHC_CACHE_MAX_AGE_INTERVALS * NSEC_PER_MSEC;
+	if (elapsed_ns > max_age_ns)
+		return -EAGAIN;
+
+	ts_ns = phc_ns + elapsed_ns +
+		div_s64((s64)elapsed_ns * drift_ppb, NSEC_PER_SEC);
+
+	/* Never go back behind a time returned from the previous sample */
+	last_ns = atomic64_read(&cache->last_ns);
+	while ((s64)(ts_ns - last_ns) > 0) {
+		prev_ns = atomic64_cmpxchg(&cache->last_ns, last_ns, ts_ns);
+		if (prev_ns == last_ns)
+			break;
+		last_ns = prev_ns;
+	}
+
+	if ((s64)(ts_ns - last_ns) < 0)
+		ts_ns = last_ns;
+
+	*timestamp = ts_ns;
+
+	if (error_bound)
+		*error_bound = min_t(u64, U32_MAX,
+				     sample_err_ns +
+				     div_u64(elapsed_ns * drift_err_ppb, NSEC_PER_SEC));
+
+	return 0;
+}
+
+static void ena_phc_cache_reset(struct ena_phc_info *phc_info)
+{
+	struct ena_phc_cache *cache = &phc_info->cache;
+
+	write_seqlock(&cache->lock);
+	cache->valid = false;
+	cache->drift_ppb = 0;
+	cache->drift_err_ppb = ENA_PHC_CACHE_MAX_DRIFT_PPB;
+	atomic64_set(&cache->last_ns, 0);
+	write_sequnlock(&cache->lock);
+
+	phc_info->drift_base_sys_ns = 0;
+}
+
+/* Estimate the PHC drift against the raw monotonic clock over a window of
+ * at least ENA_PHC_CACHE_DRIFT_WINDOW_NS, the uncertainty of the estimation
+ * is derived from the error bounds of the two samples.
+ */
+static void ena_phc_cache_update_drift(struct ena_phc_info *phc_info,
+				       u64 phc_ns, u64 sys_ns, u32 sample_err_ns)
+{
+	struct ena_phc_cache *cache = &phc_info->cache;
+	u64 window_ns, max_offset_ns;
+	s64 offset_ns;
+
+	if (!phc_info->drift_base_sys_ns)
+		goto update_base;
+
+	window_ns = sys_ns - phc_info->drift_base_sys_ns;
+	if (window_ns < ENA_PHC_CACHE_DRIFT_WINDOW_NS)
+		return;
+
+	offset_ns = (s64)(phc_ns - phc_info->drift_base_phc_ns) - (s64)window_ns;
+	max_offset_ns = div_u64(window_ns * ENA_PHC_CACHE_MAX_DRIFT_PPB, NSEC_PER_SEC);
+
+	/* Implausible drift, e.g. the PHC was stepped, start over */
+	if (abs(offset_ns) > max_offset_ns) {
+		cache->drift_ppb = 0;
+		cache->drift_err_ppb = ENA_PHC_CACHE_MAX_DRIFT_PPB;
+		goto update_base;
+	}
+
+	cache->drift_ppb = div64_s64(offset_ns * NSEC_PER_SEC, window_ns);
+	cache->drift_err_ppb =
+		min_t(u64, ENA_PHC_CACHE_MAX_DRIFT_PPB,
+		      div64_u64((u64)(sample_err_ns + phc_info->drift_base_err_ns) *
+				NSEC_PER_SEC, window_ns));
+
+update_base:
+	phc_info->drift_base_phc_ns = phc_ns;
+	phc_info->drift_base_sys_ns = sys_ns;
+	phc_info->drift_base_err_ns = sample_err_ns;
+}
+
+static void ena_phc_cache_update(struct ena_phc_info *phc_info)
+{
+	struct ena_com_dev *ena_dev = phc_info->adapter->ena_dev;
+	struct ena_phc_cache *cache = &phc_info->cache;
+	u64 pre_ns, post_ns, phc_ns, sys_ns;
+	u32 error_bound, sample_err_ns;
+	unsigned long flags;
+	int rc;
+
+	spin_lock_irqsave(&phc_info->lock, flags);
+
+	pre_ns = ktime_get_raw_ns();
+	rc = ena_com_phc_get_timestamp(ena_dev, &phc_ns);
+	post_ns = ktime_get_raw_ns();
+	if (!rc)
+		rc = ena_com_phc_get_error_bound(ena_dev, &error_bound);
+
+	spin_unlock_irqrestore(&phc_info->lock, flags);
+
+	/* Keep the previous sample, readers stop using it once it ages out */
+	if (unlikely(rc))
+		return;
+
+	/* The device sampled its clock somewhere within the request */
+	sys_ns = pre_ns + (post_ns - pre_ns) / 2;
+	sample_err_ns = min_t(u64, U32_MAX, error_bound + (post_ns - pre_ns) / 2);
+
+	write_seqlock(&cache->lock);
+	ena_phc_cache_update_drift(phc_info, phc_ns, sys_ns, sample_err_ns);
+	cache->phc_ns = phc_ns;
+	cache->sys_ns = sys_ns;
+	cache->sample_err_ns = sample_err_ns;
+	cache->valid = true;
+	write_sequnlock(&cache->lock);
+}
+
+static void ena_phc_cache_refresh(struct work_struct *work)
+{
+	struct ena_phc_info *phc_info =
+		container_of(to_delayed_work(work), struct ena_phc_info, cache_work);
+
+	ena_phc_cache_update(phc_info);
+
+	schedule_delayed_work(&phc_info->cache_work,
+			      msecs_to_jiffies(phc_info->cache_interval_ms));
+}
+
 #ifdef ENA_PHC_SUPPORT_GETTIME64
 #ifdef ENA_PHC_SUPPORT_GETTIME64_EXTENDED
 static int ena_phc_gettimex64(struct ptp_clock_info *clock_info,
@@ -47,6 +216,12 @@ static int ena_phc_gettimex64(struct ptp_clock_info *clock_info,
 	u64 timestamp_nsec;
 	int rc;
 
+	ptp_read_system_prets(sts);
+	rc = ena_phc_cache_get(phc_info, &timestamp_nsec, NULL);
+	ptp_read_system_postts(sts);
+	if (!rc)
+		goto out;
+
 	spin_lock_irqsave(&phc_info->lock, flags);
 
 	ptp_read_system_prets(sts);
@@ -61,6 +236,7 @@ static int ena_phc_gettimex64(struct ptp_clock_info *clock_info,
 	if (rc)
 		return rc;
 
+out:
 	*ts = ns_to_timespec64(timestamp_nsec);
 
 	return 0;
@@ -75,6 +251,9 @@ static int ena_phc_gettime64(struct ptp_clock_info *clock_info, struct timespec6
 	u64 timestamp_nsec;
 	int rc;
 
+	if (!ena_phc_cache_get(phc_info, &timestamp_nsec, NULL))
+		goto out;
+
 	spin_lock_irqsave(&phc_info->lock, flags);
 
 	rc = ena_com_phc_get_timestamp(phc_info->adapter->ena_dev,
@@ -85,6 +264,7 @@ static int ena_phc_gettime64(struct ptp_clock_info *clock_info, struct timespec6
 	if (rc)
 		return rc;
 
+out:
 	*ts = ns_to_timespec64(timestamp_nsec);
 
 	return 0;
@@ -107,6 +287,9 @@ static int ena_phc_gettime(struct ptp_clock_info *clock_info, struct timespec *t
 	u32 remainder;
 	int rc;
 
+	if (!ena_phc_cache_get(phc_info, &timestamp_nsec, NULL))
+		goto out;
+
 	spin_lock_irqsave(&phc_info->lock, flags);
 
 	rc = ena_com_phc_get_timestamp(phc_info->adapter->ena_dev,
@@ -117,6 +300,7 @@ static int ena_phc_gettime(struct ptp_clock_info *clock_info, struct timespec *t
 	if (rc)
 		return rc;
 
+out:
 	ts->tv_sec = div_u64_rem(timestamp_nsec, NSEC_PER_SEC, &remainder);
 	ts->tv_nsec = remainder;
 
@@ -169,6 +353,26 @@ void ena_phc_enable(struct ena_adapter *adapter, bool enable)
 	phc_info->enabled = enable;
 }
 
+/* Serve get time requests from a sample refreshed every interval_ms,
+ * 0 disables the cache. Affects on the next init flow.
+ */
+void ena_phc_set_cache_interval(struct ena_adapter *adapter, u32 interval_ms)
+{
+	struct ena_phc_info *phc_info = adapter->phc_info;
+
+	if (!phc_info) {
+		netdev_err(adapter->netdev, "phc_info is not allocated\n");
+		return;
+	}
+
+	if (interval_ms)
+		interval_ms = clamp_t(u32, interval_ms,
+				      ENA_PHC_CACHE_MIN_INTERVAL_MS,
+				      ENA_PHC_CACHE_MAX_INTERVAL_MS);
+
+	phc_info->cache_interval_ms = interval_ms;
+}
+
 /* Check if PHC is enabled by the kernel */
 bool ena_phc_is_enabled(struct ena_adapter *adapter)
 {
@@ -244,6 +448,9 @@ int ena_phc_alloc(struct ena_adapter *adapter)
 		return -ENOMEM;
 	}
 
+	seqlock_init(&adapter->phc_info->cache.lock);
+	INIT_DELAYED_WORK(&adapter->phc_info->cache_work, ena_phc_cache_refresh);
+
 	return 0;
 }
 
@@ -294,6 +501,11 @@ int ena_phc_init(struct ena_adapter *adapter)
 		goto err_ena_com_phc_config;
 	}
 
+	if (ena_phc_cache_enabled(adapter->phc_info)) {
+		ena_phc_cache_reset(adapter->phc_info);
+		schedule_delayed_work(&adapter->phc_info->cache_work, 0);
+	}
+
 	return 0;
 
 err_ena_com_phc_config:
@@ -306,6 +518,8 @@ err_ena_com_phc_init:
 
 void ena_phc_destroy(struct ena_adapter *adapter)
 {
+	cancel_delayed_work_sync(&adapter->phc_info->cache_work);
+	ena_phc_cache_reset(adapter->phc_info);
 	ena_phc_unregister(adapter);
 	ena_com_phc_destroy(adapter->ena_dev);
 }
@@ -320,9 +534,15 @@ int ena_phc_get_index(struct ena_adapter *adapter)
 
 int ena_phc_get_error_bound(struct ena_adapter *adapter, u32 *error_bound_nsec)
 {
+	u64 timestamp_nsec;
+
 	if (!ena_phc_is_active(adapter))
 		return -EOPNOTSUPP;
 
+	/* Error bound of the interpolated time served from the cache */
+	if (!ena_phc_cache_get(adapter->phc_info, &timestamp_nsec, error_bound_nsec))
+		return 0;
+
 	return ena_com_phc_get_error_bound(adapter->ena_dev, error_bound_nsec);
 }
 #endif /* ENA_PHC_SUPPORT */
@@ -8,6 +8,44 @@
 
 #ifdef ENA_PHC_SUPPORT
 #include <linux/ptp_clock_kernel.h>
+#include <linux/seqlock.h>
+
+/* The device limits get time requests to 125 per second */
+#define ENA_PHC_CACHE_MIN_INTERVAL_MS	10
+#define ENA_PHC_CACHE_MAX_INTERVAL_MS	1000
+/* Cached samples older than this many refresh intervals are not used */
+#define ENA_PHC_CACHE_MAX_AGE_INTERVALS	4
+/* Minimal time between the two samples used to estimate the clock drift */
+#define ENA_PHC_CACHE_DRIFT_WINDOW_NS	NSEC_PER_SEC
+/* Drift assumed before it is estimated, and the highest accepted estimate */
+#define ENA_PHC_CACHE_MAX_DRIFT_PPB	200000
+
+/* Last PHC sample taken by the refresher, used to serve get time requests
+ * without accessing the device. The PHC time is interpolated from the sample
+ * using the raw monotonic clock, corrected by the estimated drift between
+ * the two clocks.
+ */
+struct ena_phc_cache {
+	seqlock_t lock;
+
+	/* PHC time of the sample and the raw monotonic time it was taken at */
+	u64 phc_ns;
+	u64 sys_ns;
+
+	/* Device error bound plus half of the request round trip */
+	u32 sample_err_ns;
+
+	/* PHC drift relative to the raw monotonic clock and its uncertainty */
+	s32 drift_ppb;
+	u32 drift_err_ppb;
+
+	bool valid;
+
+	/* Last interpolated time returned, keeps the interpolation monotonic
+	 * when a new sample is behind it
+	 */
+	atomic64_t last_ns;
+};
 
 struct ena_phc_info {
 	/* PTP hardware capabilities */
@@ -24,9 +62,22 @@ struct ena_phc_info {
 
 	/* Enabled by kernel */
 	bool enabled;
+
+	/* Refresh interval of the cached sample, 0 when caching is disabled */
+	u32 cache_interval_ms;
+
+	/* Cached sample, updated by cache_work */
+	struct ena_phc_cache cache;
+	struct delayed_work cache_work;
+
+	/* Refresher private sample the drift is estimated against */
+	u64 drift_base_phc_ns;
+	u64 drift_base_sys_ns;
+	u32 drift_base_err_ns;
 };
 
 void ena_phc_enable(struct ena_adapter *adapter, bool enable);
+void ena_phc_set_cache_interval(struct ena_adapter *adapter, u32 interval_ms);
 bool ena_phc_is_enabled(struct ena_adapter *adapter);
 bool ena_phc_is_active(struct ena_adapter *adapter);
 int ena_phc_get_index(struct ena_adapter *adapter);
@@ -38,6 +89,7 @@ int ena_phc_get_error_bound(struct ena_adapter *adapter, u32 *error_bound);
 #else /* ENA_PHC_SUPPORT */
 
 static inline void ena_phc_enable(struct ena_adapter *adapter, bool enable) { }
+static inline void ena_phc_set_cache_interval(struct ena_adapter *adapter, u32 interval_ms) { }
 static inline bool ena_phc_is_enabled(struct ena_adapter *adapter) { return false; }
 static inline bool ena_phc_is_active(struct ena_adapter *adapter) { return false; }
 static inline int ena_phc_get_index(struct ena_adapter *adapter) { return -1; }
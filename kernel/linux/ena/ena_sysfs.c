@@ -98,6 +98,7 @@ static ssize_t ena_large_llq_set(struct device *dev,
 		goto unlock;
 
 	adapter->llq_policy = new_llq_policy;
+	adapter->large_llq_auto = false;
 
 	rc = ena_destroy_device(adapter, false);
 	rc |= ena_restore_device(adapter);
@@ -127,6 +128,28 @@ static ssize_t ena_large_llq_show(struct device *dev,
 static DEVICE_ATTR(large_llq_header, S_IRUGO | S_IWUSR, ena_large_llq_show,
 		   ena_large_llq_set);
 
+static ssize_t ena_large_llq_recommended_show(struct device *dev,
+					      struct device_attribute *attr, char *buf)
+{
+	struct ena_adapter *adapter = dev_get_drvdata(dev);
+	enum ena_llq_header_size_policy_t recommended;
+
+	/* Without a recommendation, report the header size currently in use, or
+	 * the one the device would choose if there is none yet
+	 */
+	recommended = ena_large_llq_recommendation(adapter);
+	if (recommended == ENA_LLQ_HEADER_SIZE_POLICY_UNSPECIFIED)
+		recommended = adapter->llq_policy;
+	if (recommended == ENA_LLQ_HEADER_SIZE_POLICY_UNSPECIFIED)
+		recommended = adapter->llq_default_policy;
+
+	return snprintf(buf, ENA_LARGE_LLQ_STR_MAX_LEN, "%d\n",
+			recommended == ENA_LLQ_HEADER_SIZE_POLICY_LARGE);
+}
+
+static DEVICE_ATTR(large_llq_header_recommended, S_IRUGO,
+		   ena_large_llq_recommended_show, NULL);
+
 /* Enough to cover each print string and the value */
 #define ENA_HW_PACKET_TIMESTAMPING_MAX_LEN 32
 static ssize_t ena_hw_packet_timestamping_show(struct device *dev,
@@ -179,7 +202,8 @@ int ena_sysfs_init(struct device *dev)
 		dev_err(dev, "Failed to create rx_copybreak sysfs entry");
 
 #ifdef ENA_PHC_SUPPORT
-	if (ena_phc_is_active(dev_get_drvdata(dev)))
+	/* PHC is activated only after probe, see ena_complete_deferred_init() */
+	if (ena_phc_is_enabled(dev_get_drvdata(dev)))
 		if (device_create_file(dev, &dev_attr_phc_error_bound))
 			dev_err(dev, "Failed to create phc_error_bound sysfs entry");
 
@@ -188,6 +212,9 @@ int ena_sysfs_init(struct device *dev)
 	if (device_create_file(dev, &dev_attr_large_llq_header))
 		dev_err(dev, "Failed to create large_llq_header sysfs entry");
 
+	if (device_create_file(dev, &dev_attr_large_llq_header_recommended))
+		dev_err(dev, "Failed to create large_llq_header_recommended sysfs entry");
+
 	if (device_create_file(dev, &dev_attr_hw_packet_timestamping_state))
 		dev_err(dev, "Failed to create hw_packet_timestamping_state sysfs entry");
 	return 0;
@@ -202,5 +229,6 @@ void ena_sysfs_terminate(struct device *dev)
 	device_remove_file(dev, &dev_attr_phc_error_bound);
 #endif /* ENA_PHC_SUPPORT */
 	device_remove_file(dev, &dev_attr_large_llq_header);
+	device_remove_file(dev, &dev_attr_large_llq_header_recommended);
 	device_remove_file(dev, &dev_attr_hw_packet_timestamping_state);
 }
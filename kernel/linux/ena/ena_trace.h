@@ -0,0 +1,145 @@
+/* SPDX-License-Identifier: GPL-2.0 OR Linux-OpenIB */
+/* Copyright (c) Amazon.com, Inc. or its affiliates.
+ * All rights reserved.
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM ena
+
+#if !defined(_ENA_TRACE_H_) || defined(TRACE_HEADER_MULTI_READ)
+#define _ENA_TRACE_H_
+
+#include <linux/tracepoint.h>
+
+TRACE_EVENT(ena_xmit,
+	TP_PROTO(int ifindex, u16 qid, u16 req_id, u32 bytes, u16 descs),
+
+	TP_ARGS(ifindex, qid, req_id, bytes, descs),
+
+	TP_STRUCT__entry(
+		__field(int, ifindex)
+		__field(u16, qid)
+		__field(u16, req_id)
+		__field(u32, bytes)
+		__field(u16, descs)
+	),
+
+	TP_fast_assign(
+		__entry->ifindex = ifindex;
+		__entry->qid = qid;
+		__entry->req_id = req_id;
+		__entry->bytes = bytes;
+		__entry->descs = descs;
+	),
+
+	TP_printk("ifindex=%d qid=%u req_id=%u bytes=%u descs=%u",
+		  __entry->ifindex, __entry->qid, __entry->req_id,
+		  __entry->bytes, __entry->descs)
+);
+
+TRACE_EVENT(ena_tx_doorbell,
+	TP_PROTO(int ifindex, u16 qid, u16 next_to_use),
+
+	TP_ARGS(ifindex, qid, next_to_use),
+
+	TP_STRUCT__entry(
+		__field(int, ifindex)
+		__field(u16, qid)
+		__field(u16, next_to_use)
+	),
+
+	TP_fast_assign(
+		__entry->ifindex = ifindex;
+		__entry->qid = qid;
+		__entry->next_to_use = next_to_use;
+	),
+
+	TP_printk("ifindex=%d qid=%u next_to_use=%u",
+		  __entry->ifindex, __entry->qid, __entry->next_to_use)
+);
+
+TRACE_EVENT(ena_clean_tx_irq,
+	TP_PROTO(int ifindex, u16 qid, u32 budget, u32 pkts, u32 descs),
+
+	TP_ARGS(ifindex, qid, budget, pkts, descs),
+
+	TP_STRUCT__entry(
+		__field(int, ifindex)
+		__field(u16, qid)
+		__field(u32, budget)
+		__field(u32, pkts)
+		__field(u32, descs)
+	),
+
+	TP_fast_assign(
+		__entry->ifindex = ifindex;
+		__entry->qid = qid;
+		__entry->budget = budget;
+		__entry->pkts = pkts;
+		__entry->descs = descs;
+	),
+
+	TP_printk("ifindex=%d qid=%u budget=%u pkts=%u descs=%u",
+		  __entry->ifindex, __entry->qid, __entry->budget,
+		  __entry->pkts, __entry->descs)
+);
+
+TRACE_EVENT(ena_clean_rx_irq,
+	TP_PROTO(int ifindex, u16 qid, u32 budget, u32 pkts,
+		 u32 refill_required),
+
+	TP_ARGS(ifindex, qid, budget, pkts, refill_required),
+
+	TP_STRUCT__entry(
+		__field(int, ifindex)
+		__field(u16, qid)
+		__field(u32, budget)
+		__field(u32, pkts)
+		__field(u32, refill_required)
+	),
+
+	TP_fast_assign(
+		__entry->ifindex = ifindex;
+		__entry->qid = qid;
+		__entry->budget = budget;
+		__entry->pkts = pkts;
+		__entry->refill_required = refill_required;
+	),
+
+	TP_printk("ifindex=%d qid=%u budget=%u pkts=%u refill_required=%u",
+		  __entry->ifindex, __entry->qid, __entry->budget,
+		  __entry->pkts, __entry->refill_required)
+);
+
+TRACE_EVENT(ena_refill_rx_bufs,
+	TP_PROTO(int ifindex, u16 qid, u32 requested, u32 refilled),
+
+	TP_ARGS(ifindex, qid, requested, refilled),
+
+	TP_STRUCT__entry(
+		__field(int, ifindex)
+		__field(u16, qid)
+		__field(u32, requested)
+		__field(u32, refilled)
+	),
+
+	TP_fast_assign(
+		__entry->ifindex = ifindex;
+		__entry->qid = qid;
+		__entry->requested = requested;
+		__entry->refilled = refilled;
+	),
+
+	TP_printk("ifindex=%d qid=%u requested=%u refilled=%u deficit=%u",
+		  __entry->ifindex, __entry->qid, __entry->requested,
+		  __entry->refilled, __entry->requested - __entry->refilled)
+);
+
+#endif /* _ENA_TRACE_H_ */
+
+/* This part must be outside protection */
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE ena_trace
+#include <trace/define_trace.h>
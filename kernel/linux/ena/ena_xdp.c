@@ -662,6 +662,8 @@ static bool ena_xdp_clean_tx_zc(struct ena_ring *tx_ring, u32 budget)
 
 		tx_info = &tx_ring->tx_buffer_info[req_id];
 
+		ena_tx_lat_sample_complete(tx_ring, req_id);
+
 		/* The pending_timedout_pkts counter is incremented for each
 		 * timed out packet. Therefore in tx cleanup routine we need to
 		 * count those timed out pkts, to maintain accurate statistics
@@ -684,6 +686,7 @@ static bool ena_xdp_clean_tx_zc(struct ena_ring *tx_ring, u32 budget)
 			skb_tstamp_tx(skb, &tx_hw_timestamp);
 		}
 
+		ena_tx_pending_completed(tx_ring, tx_info->tx_sent_jiffies);
 		tx_info->tx_sent_jiffies = 0;
 
 		tx_info->acked = 1;
@@ -1300,7 +1303,21 @@ static int ena_xdp_rx_hash(const struct xdp_md *ctx, u32 *hash,
 	if (!ena_is_rx_hash_valid(ena_rx_ctx))
 		return -ENODATA;
 
-	*rss_type = XDP_RSS_TYPE_L4_ANY;
+	/* A valid hash implies the packet is TCP or UDP */
+	switch (ena_rx_ctx->l3_proto) {
+	case ENA_ETH_IO_L3_PROTO_IPV4:
+		*rss_type = ena_rx_ctx->l4_proto == ENA_ETH_IO_L4_PROTO_TCP ?
+			    XDP_RSS_TYPE_L4_IPV4_TCP : XDP_RSS_TYPE_L4_IPV4_UDP;
+		break;
+	case ENA_ETH_IO_L3_PROTO_IPV6:
+		*rss_type = ena_rx_ctx->l4_proto == ENA_ETH_IO_L4_PROTO_TCP ?
+			    XDP_RSS_TYPE_L4_IPV6_TCP : XDP_RSS_TYPE_L4_IPV6_UDP;
+		break;
+	default:
+		*rss_type = XDP_RSS_TYPE_L4_ANY;
+		break;
+	}
+
 	*hash = ena_rx_ctx->hash;
 
 	return 0;
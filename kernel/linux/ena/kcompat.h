@@ -1117,4 +1117,18 @@ static inline void txq_trans_cond_update(struct netdev_queue *txq)
 }
 #endif /* ENA_HAVE_TXQ_TRANS_UPDATE */
 
+#ifndef ENA_HAVE_HRTIMER_SETUP
+static inline void hrtimer_setup(struct hrtimer *timer,
+				 enum hrtimer_restart (*function)(struct hrtimer *),
+				 clockid_t clock_id, enum hrtimer_mode mode)
+{
+	hrtimer_init(timer, clock_id, mode);
+	timer->function = function;
+}
+#endif /* ENA_HAVE_HRTIMER_SETUP */
+
+#ifdef NETIF_F_GSO_UDP_L4
+#define ENA_UDP_GSO_SUPPORT
+#endif /* NETIF_F_GSO_UDP_L4 */
+
 #endif /* _KCOMPAT_H_ */
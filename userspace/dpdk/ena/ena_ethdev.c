@@ -9,6 +9,8 @@
 #include <rte_version.h>
 #include <rte_net.h>
 #include <rte_kvargs.h>
+#include <rte_service_component.h>
+#include <rte_vect.h>
 
 #include "ena_ethdev.h"
 #include "ena_logs.h"
@@ -107,6 +109,15 @@ struct ena_stats {
  */
 #define ENA_DEVARG_CONTROL_PATH_POLL_INTERVAL "control_path_poll_interval"
 
+/*
+ * Run the control path (admin and AENQ queues processing, keep alive and
+ * missing Tx completions checks) as an rte_service component, instead of the
+ * interrupts, alarms and rte_timer. The application has to map the service
+ * (named "net_ena_ctrl_<port_id>") to a service lcore and set its runstate.
+ * If enabled, it takes precedence over the control_path_poll_interval.
+ */
+#define ENA_DEVARG_CONTROL_PATH_SERVICE "control_path_service"
+
 /*
  * Each rte_memzone should have unique name.
  * To satisfy it, count number of allocation and add it to name.
@@ -221,6 +232,9 @@ static const struct rte_pci_id pci_id_ena_map[] = {
 
 static struct ena_aenq_handlers aenq_handlers;
 
+/* Adapter whose control path service is being executed by the lcore */
+static RTE_DEFINE_PER_LCORE(struct ena_adapter *, ena_control_path_service_adapter);
+
 static int ena_device_init(struct ena_adapter *adapter,
 			   struct rte_pci_device *pdev,
 			   struct ena_com_dev_get_features_ctx *get_feat_ctx);
@@ -231,9 +245,6 @@ static void ena_tx_map_mbuf(struct ena_ring *tx_ring,
 	void **push_header,
 	uint16_t *header_len);
 static int ena_xmit_mbuf(struct ena_ring *tx_ring, struct rte_mbuf *mbuf);
-static int ena_tx_cleanup(void *txp, uint32_t free_pkt_cnt);
-static uint16_t eth_ena_xmit_pkts(void *tx_queue, struct rte_mbuf **tx_pkts,
-				  uint16_t nb_pkts);
 static uint16_t eth_ena_prep_pkts(void *tx_queue, struct rte_mbuf **tx_pkts,
 		uint16_t nb_pkts);
 static int ena_tx_queue_setup(struct rte_eth_dev *dev, uint16_t queue_idx,
@@ -249,11 +260,9 @@ static struct rte_mbuf *ena_rx_mbuf(struct ena_ring *rx_ring,
 				    uint32_t descs,
 				    uint16_t *next_to_clean,
 				    uint8_t offset);
-static uint16_t eth_ena_recv_pkts(void *rx_queue,
-				  struct rte_mbuf **rx_pkts, uint16_t nb_pkts);
 static int ena_add_single_rx_desc(struct ena_com_io_sq *io_sq,
 				  struct rte_mbuf *mbuf, uint16_t id);
-static int ena_populate_rx_queue(struct ena_ring *rxq, unsigned int count);
+static void ena_rx_mbuf_initializer_set(struct ena_ring *rxq);
 static void ena_init_rings(struct ena_adapter *adapter,
 			   bool disable_meta_caching);
 static int ena_mtu_set(struct rte_eth_dev *dev, uint16_t mtu);
@@ -286,6 +295,10 @@ static int ena_infos_get(struct rte_eth_dev *dev,
 			 struct rte_eth_dev_info *dev_info);
 static void ena_control_path_handler(void *cb_arg);
 static void ena_control_path_poll_handler(void *cb_arg);
+static int32_t ena_control_path_service_run(void *arg);
+static int ena_control_path_service_register(struct rte_eth_dev *dev);
+static void ena_control_path_service_pause(struct ena_adapter *adapter);
+static void ena_control_path_service_resume(struct ena_adapter *adapter);
 static void ena_timer_wd_callback(struct rte_timer *timer, void *arg);
 static int eth_ena_dev_init(struct rte_eth_dev *eth_dev);
 static int eth_ena_dev_uninit(struct rte_eth_dev *eth_dev);
@@ -313,15 +326,38 @@ static void ena_copy_customer_metrics(struct ena_adapter *adapter,
 					size_t buf_size);
 static void ena_copy_ena_srd_info(struct ena_adapter *adapter,
 				  struct ena_stats_srd *srd_info);
+static bool ena_stats_snapshot_get(struct ena_adapter *adapter,
+				   struct ena_stats_snapshot *snapshot);
+static void ena_stats_snapshot_update(struct ena_adapter *adapter);
 static int ena_setup_rx_intr(struct rte_eth_dev *dev);
 static int ena_rx_queue_intr_enable(struct rte_eth_dev *dev,
 				    uint16_t queue_id);
 static int ena_rx_queue_intr_disable(struct rte_eth_dev *dev,
 				     uint16_t queue_id);
+static int ena_get_monitor_addr(void *rx_queue,
+				struct rte_power_monitor_cond *pmc);
+static int ena_rx_queue_count(void *rx_queue);
+static void ena_recycle_rxq_info_get(struct rte_eth_dev *dev,
+				     uint16_t queue_id,
+				     struct rte_eth_recycle_rxq_info *recycle_rxq_info);
+static uint16_t ena_recycle_tx_mbufs_reuse(void *tx_queue,
+	struct rte_eth_recycle_rxq_info *recycle_rxq_info);
+static void ena_recycle_rx_descriptors_refill(void *rx_queue,
+					      uint16_t nb_mbufs);
+static int ena_rx_descriptor_status(void *rx_queue, uint16_t offset);
+static int ena_tx_descriptor_status(void *tx_queue, uint16_t offset);
 static int ena_configure_aenq(struct ena_adapter *adapter);
 static int ena_mp_primary_handle(const struct rte_mp_msg *mp_msg,
 				 const void *peer);
 static bool ena_use_large_llq_hdr(struct ena_adapter *adapter, uint8_t recommended_entry_size);
+static void ena_set_rx_function(struct rte_eth_dev *dev);
+static int ena_rx_burst_mode_get(struct rte_eth_dev *dev, uint16_t queue_id,
+				 struct rte_eth_burst_mode *mode);
+static bool ena_tx_simple_allowed(struct ena_adapter *adapter,
+				  struct ena_ring *txq);
+static void ena_set_tx_function(struct rte_eth_dev *dev);
+static int ena_tx_burst_mode_get(struct rte_eth_dev *dev, uint16_t queue_id,
+				 struct rte_eth_burst_mode *mode);
 
 static const struct eth_dev_ops ena_dev_ops = {
 	.dev_configure          = ena_dev_configure,
@@ -348,6 +384,11 @@ static const struct eth_dev_ops ena_dev_ops = {
 	.rss_hash_update        = ena_rss_hash_update,
 	.rss_hash_conf_get      = ena_rss_hash_conf_get,
 	.tx_done_cleanup        = ena_tx_cleanup,
+	.rx_burst_mode_get      = ena_rx_burst_mode_get,
+	.tx_burst_mode_get      = ena_tx_burst_mode_get,
+	.get_monitor_addr       = ena_get_monitor_addr,
+	.recycle_rxq_info_get   = ena_recycle_rxq_info_get,
+	.flow_ops_get           = ena_flow_ops_get,
 };
 
 /*********************************************************************
@@ -908,7 +949,11 @@ static int ena_close(struct rte_eth_dev *dev)
 		ret = ena_stop(dev);
 	adapter->state = ENA_ADAPTER_STATE_CLOSED;
 
-	if (!adapter->control_path_poll_interval) {
+	if (adapter->control_path_service) {
+		ena_control_path_service_pause(adapter);
+		if (!adapter->control_path_service_keep)
+			rte_service_component_unregister(adapter->control_path_service_id);
+	} else if (!adapter->control_path_poll_interval) {
 		rte_intr_disable(intr_handle);
 		rc = rte_intr_callback_unregister_sync(intr_handle, ena_control_path_handler, dev);
 		if (unlikely(rc != 0))
@@ -927,6 +972,9 @@ static int ena_close(struct rte_eth_dev *dev)
 
 	ena_com_rss_destroy(ena_dev);
 
+	ena_flow_list_release(adapter);
+	ena_com_flow_steering_destroy(ena_dev);
+
 	ena_com_delete_debug_area(ena_dev);
 	ena_com_delete_host_info(ena_dev);
 
@@ -948,6 +996,10 @@ static int ena_close(struct rte_eth_dev *dev)
 static int
 ena_dev_reset(struct rte_eth_dev *dev)
 {
+	struct ena_adapter *adapter = dev->data->dev_private;
+	struct ena_flow_list flow_list;
+	bool service_kept;
+	uint32_t service_id;
 	int rc = 0;
 
 	/* Cannot release memory in secondary process */
@@ -956,15 +1008,42 @@ ena_dev_reset(struct rte_eth_dev *dev)
 		return -EPERM;
 	}
 
+	/* The flow rules are kept across the reset */
+	ena_flow_list_save(adapter, &flow_list);
+
+	/*
+	 * The control path service is kept registered, so the application's
+	 * service lcore mapping stays valid.
+	 */
+	adapter->control_path_service_keep = true;
+	service_kept = adapter->control_path_service &&
+		adapter->state != ENA_ADAPTER_STATE_CLOSED;
+	service_id = adapter->control_path_service_id;
+
+	/* The port is closed even if uninit fails */
 	rc = eth_ena_dev_uninit(dev);
+	adapter->control_path_service_keep = false;
 	if (rc) {
 		PMD_INIT_LOG_LINE(CRIT, "Failed to un-initialize device");
-		return rc;
+		goto err_service_unregister;
 	}
 
 	rc = eth_ena_dev_init(dev);
-	if (rc)
+	if (rc) {
 		PMD_INIT_LOG_LINE(CRIT, "Cannot initialize device");
+		goto err_service_unregister;
+	}
+
+	rc = ena_flow_list_restore(adapter, &flow_list);
+	if (rc)
+		PMD_INIT_LOG_LINE(ERR, "Failed to restore the flow rules");
+
+	return rc;
+
+err_service_unregister:
+	if (service_kept)
+		rte_service_component_unregister(service_id);
+	ena_flow_list_invalidate(adapter, &flow_list);
 
 	return rc;
 }
@@ -1212,10 +1291,13 @@ ena_calc_io_queue_size(struct ena_calc_queue_size_ctx *ctx,
 static void ena_stats_restart(struct rte_eth_dev *dev)
 {
 	struct ena_adapter *adapter = dev->data->dev_private;
+	int i;
 
-	rte_atomic64_init(&adapter->drv_stats->ierrors);
+	for (i = 0; i < dev->data->nb_rx_queues; i++) {
+		adapter->rx_ring[i].ierrors = 0;
+		adapter->rx_ring[i].rx_nombuf = 0;
+	}
 	rte_atomic64_init(&adapter->drv_stats->oerrors);
-	rte_atomic64_init(&adapter->drv_stats->rx_nombuf);
 	adapter->drv_stats->rx_drops = 0;
 }
 
@@ -1225,19 +1307,24 @@ static int ena_stats_get(struct rte_eth_dev *dev,
 	struct ena_admin_basic_stats ena_stats;
 	struct ena_adapter *adapter = dev->data->dev_private;
 	struct ena_com_dev *ena_dev = &adapter->ena_dev;
+	struct ena_stats_snapshot snapshot;
 	int rc;
 	int i;
 	int max_rings_stats;
 
 	memset(&ena_stats, 0, sizeof(ena_stats));
 
-	rte_spinlock_lock(&adapter->admin_lock);
-	rc = ENA_PROXY(adapter, ena_com_get_dev_basic_stats, ena_dev,
-		       &ena_stats);
-	rte_spinlock_unlock(&adapter->admin_lock);
-	if (unlikely(rc)) {
-		PMD_DRV_LOG_LINE(ERR, "Could not retrieve statistics from ENA");
-		return rc;
+	if (ena_stats_snapshot_get(adapter, &snapshot)) {
+		ena_stats = snapshot.basic_stats;
+	} else {
+		rte_spinlock_lock(&adapter->admin_lock);
+		rc = ENA_PROXY(adapter, ena_com_get_dev_basic_stats, ena_dev,
+			       &ena_stats);
+		rte_spinlock_unlock(&adapter->admin_lock);
+		if (unlikely(rc)) {
+			PMD_DRV_LOG_LINE(ERR, "Could not retrieve statistics from ENA");
+			return rc;
+		}
 	}
 
 	/* Set of basic statistics from ENA */
@@ -1252,9 +1339,11 @@ static int ena_stats_get(struct rte_eth_dev *dev,
 
 	/* Driver related stats */
 	stats->imissed = adapter->drv_stats->rx_drops;
-	stats->ierrors = rte_atomic64_read(&adapter->drv_stats->ierrors);
 	stats->oerrors = rte_atomic64_read(&adapter->drv_stats->oerrors);
-	stats->rx_nombuf = rte_atomic64_read(&adapter->drv_stats->rx_nombuf);
+	for (i = 0; i < dev->data->nb_rx_queues; ++i) {
+		stats->ierrors += adapter->rx_ring[i].ierrors;
+		stats->rx_nombuf += adapter->rx_ring[i].rx_nombuf;
+	}
 
 	max_rings_stats = RTE_MIN(dev->data->nb_rx_queues,
 		RTE_ETHDEV_QUEUE_STAT_CNTRS);
@@ -1328,6 +1417,9 @@ static int ena_start(struct rte_eth_dev *dev)
 	if (rc)
 		goto err_start_tx;
 
+	ena_set_rx_function(dev);
+	ena_set_tx_function(dev);
+
 	if (adapter->edev_data->dev_conf.rxmode.mq_mode & RTE_ETH_MQ_RX_RSS_FLAG) {
 		rc = ena_rss_configure(adapter);
 		if (rc)
@@ -1340,8 +1432,11 @@ static int ena_start(struct rte_eth_dev *dev)
 	adapter->keep_alive_timeout = ENA_DEVICE_KALIVE_TIMEOUT;
 
 	ticks = rte_get_timer_hz();
-	rte_timer_reset(&adapter->timer_wd, ticks, PERIODICAL, rte_lcore_id(),
-			ena_timer_wd_callback, dev);
+	if (adapter->control_path_service)
+		adapter->timer_wd_deadline = rte_get_timer_cycles() + ticks;
+	else
+		rte_timer_reset(&adapter->timer_wd, ticks, PERIODICAL,
+				rte_lcore_id(), ena_timer_wd_callback, dev);
 
 	++adapter->dev_stats.dev_start;
 	adapter->state = ENA_ADAPTER_STATE_RUNNING;
@@ -1360,6 +1455,121 @@ err_start_tx:
 	return rc;
 }
 
+/*
+ * The Rx burst function is a per port setting, so the vector path can be used
+ * only if all of the Rx queues are capable of using it. As the device may
+ * still split the packet into multiple descriptors, the vector path falls
+ * back to the scalar one for such packets, but it's only worth using it if
+ * the application doesn't expect scattered packets.
+ */
+static void ena_set_rx_function(struct rte_eth_dev *dev)
+{
+#ifdef ENA_VEC_SUPPORT
+	struct ena_adapter *adapter = dev->data->dev_private;
+	uint16_t i;
+
+	dev->rx_pkt_burst = &eth_ena_recv_pkts;
+
+	if (adapter->edev_data->dev_conf.rxmode.offloads &
+	    RTE_ETH_RX_OFFLOAD_SCATTER)
+		return;
+
+	for (i = 0; i < dev->data->nb_rx_queues; i++) {
+		if (!ena_rx_vec_supported(&adapter->rx_ring[i]))
+			return;
+	}
+
+	PMD_DRV_LOG_LINE(INFO, "Using vector Rx burst function on port %u",
+		dev->data->port_id);
+	dev->rx_pkt_burst = &ena_recv_pkts_vec;
+#else
+	RTE_SET_USED(dev);
+#endif /* ENA_VEC_SUPPORT */
+}
+
+static int ena_rx_burst_mode_get(struct rte_eth_dev *dev,
+				 __rte_unused uint16_t queue_id,
+				 struct rte_eth_burst_mode *mode)
+{
+	const char *info = "Scalar";
+
+#ifdef ENA_VEC_SUPPORT
+	if (dev->rx_pkt_burst == &ena_recv_pkts_vec)
+		info = ENA_VEC_BURST_MODE_INFO;
+#else
+	RTE_SET_USED(dev);
+#endif /* ENA_VEC_SUPPORT */
+
+	snprintf(mode->info, sizeof(mode->info), "%s", info);
+
+	return 0;
+}
+
+/*
+ * The simple Tx path can be used if the application doesn't request any Tx
+ * offloads nor multi-segment packets and each packet, including the optional
+ * meta descriptor, fits in a single LLQ entry.
+ */
+static bool ena_tx_simple_allowed(struct ena_adapter *adapter,
+				  struct ena_ring *txq)
+{
+	struct ena_com_llq_info *llq_info = &adapter->ena_dev.llq_info;
+	uint16_t descs_before_header = txq->disable_meta_caching ? 2 : 1;
+
+	if (txq->offloads & (QUEUE_OFFLOADS | RTE_ETH_TX_OFFLOAD_MULTI_SEGS))
+		return false;
+
+	if (txq->tx_mem_queue_type != ENA_ADMIN_PLACEMENT_POLICY_DEV)
+		return false;
+
+	return llq_info->desc_stride_ctrl == ENA_ADMIN_MULTIPLE_DESCS_PER_ENTRY &&
+		llq_info->descs_num_before_header >= descs_before_header &&
+		llq_info->desc_list_entry_size <= ENA_TX_SIMPLE_MAX_ENTRY_SIZE;
+}
+
+/* As for the Rx, the Tx burst function is common for all queues of the port */
+static void ena_set_tx_function(struct rte_eth_dev *dev)
+{
+#ifdef ENA_VEC_SUPPORT
+	struct ena_adapter *adapter = dev->data->dev_private;
+	uint16_t i;
+
+	dev->tx_pkt_burst = &eth_ena_xmit_pkts;
+
+	if (rte_vect_get_max_simd_bitwidth() < RTE_VECT_SIMD_128)
+		return;
+
+	for (i = 0; i < dev->data->nb_tx_queues; i++) {
+		if (!adapter->tx_ring[i].tx_simple)
+			return;
+	}
+
+	PMD_DRV_LOG_LINE(INFO, "Using simple Tx burst function on port %u",
+		dev->data->port_id);
+	dev->tx_pkt_burst = &ena_xmit_pkts_simple;
+#else
+	RTE_SET_USED(dev);
+#endif /* ENA_VEC_SUPPORT */
+}
+
+static int ena_tx_burst_mode_get(struct rte_eth_dev *dev,
+				 __rte_unused uint16_t queue_id,
+				 struct rte_eth_burst_mode *mode)
+{
+	const char *info = "Scalar";
+
+#ifdef ENA_VEC_SUPPORT
+	if (dev->tx_pkt_burst == &ena_xmit_pkts_simple)
+		info = "Simple " ENA_VEC_BURST_MODE_INFO;
+#else
+	RTE_SET_USED(dev);
+#endif /* ENA_VEC_SUPPORT */
+
+	snprintf(mode->info, sizeof(mode->info), "%s", info);
+
+	return 0;
+}
+
 static int ena_stop(struct rte_eth_dev *dev)
 {
 	struct ena_adapter *adapter = dev->data->dev_private;
@@ -1375,7 +1585,10 @@ static int ena_stop(struct rte_eth_dev *dev)
 		return -EPERM;
 	}
 
-	rte_timer_stop_sync(&adapter->timer_wd);
+	if (adapter->control_path_service)
+		ena_control_path_service_pause(adapter);
+	else
+		rte_timer_stop_sync(&adapter->timer_wd);
 	ena_queue_stop_all(dev, ENA_RING_TYPE_TX);
 	ena_queue_stop_all(dev, ENA_RING_TYPE_RX);
 
@@ -1398,6 +1611,10 @@ static int ena_stop(struct rte_eth_dev *dev)
 	adapter->state = ENA_ADAPTER_STATE_STOPPED;
 	dev->data->dev_started = 0;
 
+	/* The watchdog won't run anymore, as the port isn't running */
+	if (adapter->control_path_service)
+		ena_control_path_service_resume(adapter);
+
 	for (i = 0; i < dev->data->nb_rx_queues; i++)
 		dev->data->rx_queue_state[i] = RTE_ETH_QUEUE_STATE_STOPPED;
 	for (i = 0; i < dev->data->nb_tx_queues; i++)
@@ -1636,6 +1853,8 @@ static int ena_tx_queue_setup(struct rte_eth_dev *dev,
 	txq->missing_tx_completion_threshold =
 		RTE_MIN(txq->ring_size / 2, ENA_DEFAULT_MISSING_COMP);
 
+	txq->tx_simple = ena_tx_simple_allowed(adapter, txq);
+
 	/* Store pointer to this queue in upper layer */
 	txq->configured = 1;
 	dev->data->tx_queues[queue_idx] = txq;
@@ -1736,6 +1955,8 @@ static int ena_rx_queue_setup(struct rte_eth_dev *dev,
 
 	rxq->offloads = rx_conf->offloads | dev->data->dev_conf.rxmode.offloads;
 
+	ena_rx_mbuf_initializer_set(rxq);
+
 	if (rx_conf->rx_free_thresh != 0) {
 		rxq->rx_free_thresh = rx_conf->rx_free_thresh;
 	} else {
@@ -1769,7 +1990,26 @@ static int ena_add_single_rx_desc(struct ena_com_io_sq *io_sq,
 	return rc;
 }
 
-static int ena_populate_rx_queue(struct ena_ring *rxq, unsigned int count)
+/*
+ * Precompute the 8 bytes of the mbuf which are starting at the rearm_data
+ * (data_off, refcnt, nb_segs and port), so the mbuf taken directly from the
+ * mempool can be initialized with a single store.
+ */
+static void ena_rx_mbuf_initializer_set(struct ena_ring *rxq)
+{
+	struct rte_mbuf mb_def = { .buf_addr = 0 };
+
+	mb_def.nb_segs = 1;
+	mb_def.data_off = RTE_PKTMBUF_HEADROOM;
+	mb_def.port = rxq->port_id;
+	rte_mbuf_refcnt_set(&mb_def, 1);
+
+	/* Prevent compiler reordering: rearm_data covers previous fields */
+	rte_compiler_barrier();
+	rxq->mbuf_initializer = *(uint64_t *)&mb_def.rearm_data;
+}
+
+int ena_populate_rx_queue(struct ena_ring *rxq, unsigned int count)
 {
 	unsigned int i;
 	int rc;
@@ -1790,10 +2030,14 @@ static int ena_populate_rx_queue(struct ena_ring *rxq, unsigned int count)
 		PMD_RX_LOG_LINE(ERR, "Bad Rx ring state");
 #endif
 
-	/* get resources for incoming packets */
-	rc = rte_pktmbuf_alloc_bulk(rxq->mb_pool, mbufs, count);
+	/*
+	 * Get resources for incoming packets. The raw mbufs have the next
+	 * pointer already cleared, the remaining fields which aren't set on
+	 * the Rx are initialized using the rearm template.
+	 */
+	rc = rte_mempool_get_bulk(rxq->mb_pool, (void **)mbufs, count);
 	if (unlikely(rc < 0)) {
-		rte_atomic64_inc(&rxq->adapter->drv_stats->rx_nombuf);
+		++rxq->rx_nombuf;
 		++rxq->rx_stats.mbuf_alloc_fail;
 		PMD_RX_LOG_LINE(DEBUG, "There are not enough free buffers");
 		return 0;
@@ -1806,6 +2050,8 @@ static int ena_populate_rx_queue(struct ena_ring *rxq, unsigned int count)
 		if (likely((i + 4) < count))
 			rte_prefetch0(mbufs[i + 4]);
 
+		*(uint64_t *)&mbuf->rearm_data = rxq->mbuf_initializer;
+
 		req_id = rxq->empty_rx_reqs[next_to_use];
 		rx_info = &rxq->rx_buffer_info[req_id];
 
@@ -1821,7 +2067,8 @@ static int ena_populate_rx_queue(struct ena_ring *rxq, unsigned int count)
 		PMD_RX_LOG_LINE(WARNING,
 			"Refilled Rx queue[%d] with only %d/%d buffers",
 			rxq->id, i, count);
-		rte_pktmbuf_free_bulk(&mbufs[i], count - i);
+		rte_mempool_put_bulk(rxq->mb_pool, (void **)&mbufs[i],
+				     count - i);
 		++rxq->rx_stats.refill_partial;
 	}
 
@@ -1946,7 +2193,12 @@ static void ena_control_path_handler(void *cb_arg)
 	struct ena_com_dev *ena_dev = &adapter->ena_dev;
 
 	if (likely(adapter->state != ENA_ADAPTER_STATE_CLOSED)) {
-		ena_com_admin_q_comp_intr_handler(ena_dev);
+		/*
+		 * In the admin polling mode the completions are processed by
+		 * the waiter under the admin queue lock.
+		 */
+		if (!ena_com_get_admin_polling_mode(ena_dev))
+			ena_com_admin_q_comp_intr_handler(ena_dev);
 		ena_com_aenq_intr_handler(ena_dev, dev);
 	}
 }
@@ -1968,6 +2220,105 @@ static void ena_control_path_poll_handler(void *cb_arg)
 	}
 }
 
+/*
+ * The control path service polls the admin and AENQ queues on every run and
+ * executes the watchdog once per second while the port is running.
+ */
+static int32_t ena_control_path_service_run(void *arg)
+{
+	struct rte_eth_dev *dev = arg;
+	struct ena_adapter *adapter = dev->data->dev_private;
+	uint64_t cur_ticks;
+
+	if (unlikely(adapter->state == ENA_ADAPTER_STATE_CLOSED))
+		return -EAGAIN;
+
+	RTE_PER_LCORE(ena_control_path_service_adapter) = adapter;
+
+	ena_control_path_handler(dev);
+
+	if (adapter->state == ENA_ADAPTER_STATE_RUNNING) {
+		cur_ticks = rte_get_timer_cycles();
+		if (cur_ticks >= adapter->timer_wd_deadline) {
+			adapter->timer_wd_deadline = cur_ticks + rte_get_timer_hz();
+			/*
+			 * The application's reset event callback may stop,
+			 * reset or close the port from here.
+			 */
+			ena_timer_wd_callback(&adapter->timer_wd, dev);
+		}
+	}
+
+	RTE_PER_LCORE(ena_control_path_service_adapter) = NULL;
+
+	return 0;
+}
+
+static int ena_control_path_service_register(struct rte_eth_dev *dev)
+{
+	struct ena_adapter *adapter = dev->data->dev_private;
+	struct rte_service_spec service;
+	int rc;
+
+	memset(&service, 0, sizeof(service));
+	snprintf(service.name, sizeof(service.name), "net_ena_ctrl_%u",
+		 dev->data->port_id);
+
+	/* The service is still registered if the device was reset */
+	if (rte_service_get_by_name(service.name,
+				    &adapter->control_path_service_id) == 0) {
+		ena_control_path_service_resume(adapter);
+		return 0;
+	}
+
+	service.socket_id = dev->data->numa_node;
+	service.callback = ena_control_path_service_run;
+	service.callback_userdata = dev;
+
+	rc = rte_service_component_register(&service,
+					    &adapter->control_path_service_id);
+	if (unlikely(rc != 0)) {
+		PMD_INIT_LOG_LINE(ERR,
+			"Failed to register the control path service, rc: %d", rc);
+		return rc;
+	}
+
+	rc = rte_service_component_runstate_set(adapter->control_path_service_id, 1);
+	if (unlikely(rc != 0)) {
+		PMD_INIT_LOG_LINE(ERR,
+			"Failed to start the control path service, rc: %d", rc);
+		rte_service_component_unregister(adapter->control_path_service_id);
+		return rc;
+	}
+
+	PMD_INIT_LOG_LINE(INFO,
+		"Control path service %s registered, it has to be mapped to a service lcore",
+		service.name);
+
+	return 0;
+}
+
+/*
+ * Stop the service and wait until it isn't executed by any lcore. If it's
+ * called from the service itself, e.g. by the application's reset event
+ * callback, the service isn't executed anywhere else, as it isn't MT safe.
+ */
+static void ena_control_path_service_pause(struct ena_adapter *adapter)
+{
+	rte_service_component_runstate_set(adapter->control_path_service_id, 0);
+
+	if (RTE_PER_LCORE(ena_control_path_service_adapter) == adapter)
+		return;
+
+	while (rte_service_may_be_active(adapter->control_path_service_id) == 1)
+		rte_pause();
+}
+
+static void ena_control_path_service_resume(struct ena_adapter *adapter)
+{
+	rte_service_component_runstate_set(adapter->control_path_service_id, 1);
+}
+
 static void check_for_missing_keep_alive(struct ena_adapter *adapter)
 {
 	if (!(adapter->active_aenq_groups & BIT(ENA_ADMIN_KEEP_ALIVE)))
@@ -2091,7 +2442,10 @@ static void ena_timer_wd_callback(__rte_unused struct rte_timer *timer,
 		PMD_DRV_LOG_LINE(ERR, "Trigger reset is on");
 		rte_eth_dev_callback_process(dev, RTE_ETH_EVENT_INTR_RESET,
 			NULL);
+		return;
 	}
+
+	ena_stats_snapshot_update(adapter);
 }
 
 static inline void
@@ -2283,6 +2637,12 @@ static int eth_ena_dev_init(struct rte_eth_dev *eth_dev)
 	eth_dev->rx_pkt_burst = &eth_ena_recv_pkts;
 	eth_dev->tx_pkt_burst = &eth_ena_xmit_pkts;
 	eth_dev->tx_pkt_prepare = &eth_ena_prep_pkts;
+	eth_dev->rx_queue_count = &ena_rx_queue_count;
+	eth_dev->rx_descriptor_status = &ena_rx_descriptor_status;
+	eth_dev->tx_descriptor_status = &ena_tx_descriptor_status;
+	eth_dev->recycle_tx_mbufs_reuse = &ena_recycle_tx_mbufs_reuse;
+	eth_dev->recycle_rx_descriptors_refill =
+		&ena_recycle_rx_descriptors_refill;
 
 	rc = ena_init_once();
 	if (rc != 0)
@@ -2295,6 +2655,7 @@ static int eth_ena_dev_init(struct rte_eth_dev *eth_dev)
 
 	memset(adapter, 0, sizeof(struct ena_adapter));
 	ena_dev = &adapter->ena_dev;
+	TAILQ_INIT(&adapter->flow_list);
 
 	adapter->edev_data = eth_dev->data;
 
@@ -2419,6 +2780,16 @@ static int eth_ena_dev_init(struct rte_eth_dev *eth_dev)
 		goto err_delete_debug_area;
 	}
 
+	if (get_feat_ctx.dev_attr.flow_steering_max_entries != 0) {
+		rc = ena_com_flow_steering_init(ena_dev,
+			get_feat_ctx.dev_attr.flow_steering_max_entries);
+		if (unlikely(rc != 0 && rc != ENA_COM_UNSUPPORTED)) {
+			PMD_DRV_LOG_LINE(ERR,
+				"Failed to initialize flow steering in ENA device");
+			goto err_rss_destroy;
+		}
+	}
+
 	adapter->drv_stats = rte_zmalloc("adapter stats",
 					 sizeof(*adapter->drv_stats),
 					 RTE_CACHE_LINE_SIZE);
@@ -2426,12 +2797,21 @@ static int eth_ena_dev_init(struct rte_eth_dev *eth_dev)
 		PMD_DRV_LOG_LINE(ERR,
 			"Failed to allocate memory for adapter statistics");
 		rc = -ENOMEM;
-		goto err_rss_destroy;
+		goto err_flow_steering_destroy;
 	}
 
 	rte_spinlock_init(&adapter->admin_lock);
-
-	if (!adapter->control_path_poll_interval) {
+	rte_seqlock_init(&adapter->stats_shared.lock);
+
+	if (adapter->control_path_service) {
+		/* Control path service mode, the admin queue stays in polling mode */
+		if (adapter->control_path_poll_interval)
+			PMD_INIT_LOG_LINE(WARNING,
+				"Control path service enabled, ignoring the poll interval");
+		rc = ena_control_path_service_register(eth_dev);
+		if (unlikely(rc != 0))
+			goto err_control_path_destroy;
+	} else if (!adapter->control_path_poll_interval) {
 		/* Control path interrupt mode */
 		rte_intr_callback_register(intr_handle, ena_control_path_handler, eth_dev);
 		rte_intr_enable(intr_handle);
@@ -2454,6 +2834,8 @@ static int eth_ena_dev_init(struct rte_eth_dev *eth_dev)
 	return 0;
 err_control_path_destroy:
 	rte_free(adapter->drv_stats);
+err_flow_steering_destroy:
+	ena_com_flow_steering_destroy(ena_dev);
 err_rss_destroy:
 	ena_com_rss_destroy(ena_dev);
 err_delete_debug_area:
@@ -2669,12 +3051,10 @@ static int ena_infos_get(struct rte_eth_dev *dev,
 	return 0;
 }
 
+/* The rest of the mbuf fields were set by the rearm template on refill */
 static inline void ena_init_rx_mbuf(struct rte_mbuf *mbuf, uint16_t len)
 {
 	mbuf->data_len = len;
-	mbuf->data_off = RTE_PKTMBUF_HEADROOM;
-	mbuf->refcnt = 1;
-	mbuf->next = NULL;
 }
 
 static struct rte_mbuf *ena_rx_mbuf(struct ena_ring *rx_ring,
@@ -2707,7 +3087,6 @@ static struct rte_mbuf *ena_rx_mbuf(struct ena_ring *rx_ring,
 	/* Fill the mbuf head with the data specific for 1st segment. */
 	mbuf_head = mbuf;
 	mbuf_head->nb_segs = descs;
-	mbuf_head->port = rx_ring->port_id;
 	mbuf_head->pkt_len = len;
 	mbuf_head->data_off += offset;
 
@@ -2771,8 +3150,8 @@ static struct rte_mbuf *ena_rx_mbuf(struct ena_ring *rx_ring,
 	return mbuf_head;
 }
 
-static uint16_t eth_ena_recv_pkts(void *rx_queue, struct rte_mbuf **rx_pkts,
-				  uint16_t nb_pkts)
+uint16_t eth_ena_recv_pkts(void *rx_queue, struct rte_mbuf **rx_pkts,
+			   uint16_t nb_pkts)
 {
 	struct ena_ring *rx_ring = (struct ena_ring *)(rx_queue);
 	unsigned int free_queue_entries;
@@ -2852,7 +3231,7 @@ static uint16_t eth_ena_recv_pkts(void *rx_queue, struct rte_mbuf **rx_pkts,
 
 		if (unlikely(mbuf->ol_flags &
 				(RTE_MBUF_F_RX_IP_CKSUM_BAD | RTE_MBUF_F_RX_L4_CKSUM_BAD)))
-			rte_atomic64_inc(&rx_ring->adapter->drv_stats->ierrors);
+			++rx_ring->ierrors;
 
 		rx_pkts[completed] = mbuf;
 		rx_ring->rx_stats.bytes += mbuf->pkt_len;
@@ -3195,7 +3574,7 @@ static int ena_xmit_mbuf(struct ena_ring *tx_ring, struct rte_mbuf *mbuf)
 	return 0;
 }
 
-static int ena_tx_cleanup(void *txp, uint32_t free_pkt_cnt)
+int ena_tx_cleanup(void *txp, uint32_t free_pkt_cnt)
 {
 	struct rte_mbuf *pkts_to_clean[ENA_CLEANUP_BUF_THRESH];
 	struct ena_ring *tx_ring = (struct ena_ring *)txp;
@@ -3269,8 +3648,146 @@ static int ena_tx_cleanup(void *txp, uint32_t free_pkt_cnt)
 	return total_tx_pkts;
 }
 
-static uint16_t eth_ena_xmit_pkts(void *tx_queue, struct rte_mbuf **tx_pkts,
-				  uint16_t nb_pkts)
+/*
+ * The Rx refill buffer is used as the recycle mbuf ring. The Tx queue puts the
+ * mbufs starting from the Rx next_to_use position, which are then posted to
+ * the device by ena_recycle_rx_descriptors_refill(). Both indexes are masked
+ * by the ring size, so the number of entries which can be refilled is derived
+ * from them the same way as the SQ free entries.
+ */
+static void ena_recycle_rxq_info_get(struct rte_eth_dev *dev,
+				     uint16_t queue_id,
+				     struct rte_eth_recycle_rxq_info *recycle_rxq_info)
+{
+	struct ena_ring *rxq = dev->data->rx_queues[queue_id];
+
+	recycle_rxq_info->mbuf_ring = rxq->rx_refill_buffer;
+	recycle_rxq_info->mp = rxq->mb_pool;
+	recycle_rxq_info->mbuf_ring_size = rxq->ring_size;
+	recycle_rxq_info->receive_tail = &rxq->next_to_clean;
+	recycle_rxq_info->refill_head = &rxq->next_to_use;
+	/* The Rx ring can be refilled with any number of buffers */
+	recycle_rxq_info->refill_requirement = 0;
+}
+
+/*
+ * Release the completed Tx packets, but instead of returning the mbufs to the
+ * mempool, put them directly to the recycle ring of the paired Rx queue. Only
+ * the single segment, directly attached mbufs from the Rx queue mempool can be
+ * reused, the rest is freed as in the regular Tx cleanup.
+ */
+static uint16_t ena_recycle_tx_mbufs_reuse(void *tx_queue,
+	struct rte_eth_recycle_rxq_info *recycle_rxq_info)
+{
+	struct ena_ring *tx_ring = (struct ena_ring *)tx_queue;
+	struct rte_mbuf **mbuf_ring = recycle_rxq_info->mbuf_ring;
+	const uint16_t mask = recycle_rxq_info->mbuf_ring_size - 1;
+	const uint16_t refill_head = *recycle_rxq_info->refill_head;
+	uint16_t next_to_clean = tx_ring->next_to_clean;
+	bool fast_free = tx_ring->offloads & RTE_ETH_TX_OFFLOAD_MBUF_FAST_FREE;
+	unsigned int total_tx_descs = 0;
+	uint16_t budget, nb_cleaned = 0, nb_recycled = 0;
+
+	/* Each cleaned packet gives at most one mbuf for the Rx queue */
+	budget = mask - ((refill_head - *recycle_rxq_info->receive_tail) & mask);
+
+	while (nb_cleaned < budget) {
+		struct ena_tx_buffer *tx_info;
+		struct rte_mbuf *mbuf;
+		uint16_t req_id;
+
+		if (ena_com_tx_comp_req_id_get(tx_ring->ena_com_io_cq, &req_id) != 0)
+			break;
+
+		if (unlikely(validate_tx_req_id(tx_ring, req_id) != 0))
+			break;
+
+		tx_info = &tx_ring->tx_buffer_info[req_id];
+		tx_info->timestamp = 0;
+
+		mbuf = tx_info->mbuf;
+		if (unlikely(mbuf->nb_segs != 1)) {
+			rte_pktmbuf_free(mbuf);
+		} else {
+			if (!fast_free)
+				mbuf = rte_pktmbuf_prefree_seg(mbuf);
+
+			if (likely(mbuf != NULL)) {
+				if (likely(mbuf->pool == recycle_rxq_info->mp))
+					mbuf_ring[(refill_head + nb_recycled++) & mask] = mbuf;
+				else
+					rte_mbuf_raw_free(mbuf);
+			}
+		}
+
+		tx_info->mbuf = NULL;
+		tx_ring->empty_tx_reqs[next_to_clean] = req_id;
+
+		total_tx_descs += tx_info->tx_descs;
+		nb_cleaned++;
+
+		next_to_clean = ENA_IDX_NEXT_MASKED(next_to_clean,
+			tx_ring->size_mask);
+	}
+
+	if (likely(total_tx_descs > 0)) {
+		tx_ring->next_to_clean = next_to_clean;
+		ena_com_comp_ack(tx_ring->ena_com_io_sq, total_tx_descs);
+	}
+
+	/* All of the pending completions were processed */
+	if (nb_cleaned < budget)
+		tx_ring->last_cleanup_ticks = rte_get_timer_cycles();
+
+	return nb_recycled;
+}
+
+static void ena_recycle_rx_descriptors_refill(void *rx_queue,
+					      uint16_t nb_mbufs)
+{
+	struct ena_ring *rxq = (struct ena_ring *)rx_queue;
+	uint16_t next_to_use = rxq->next_to_use;
+	uint16_t i, req_id;
+	int rc;
+
+	for (i = 0; i < nb_mbufs; i++) {
+		struct rte_mbuf *mbuf = rxq->rx_refill_buffer[next_to_use];
+		struct ena_rx_buffer *rx_info;
+
+		*(uint64_t *)&mbuf->rearm_data = rxq->mbuf_initializer;
+
+		req_id = rxq->empty_rx_reqs[next_to_use];
+		rx_info = &rxq->rx_buffer_info[req_id];
+
+		rc = ena_add_single_rx_desc(rxq->ena_com_io_sq, mbuf, req_id);
+		if (unlikely(rc != 0))
+			break;
+
+		rx_info->mbuf = mbuf;
+		next_to_use = ENA_IDX_NEXT_MASKED(next_to_use, rxq->size_mask);
+	}
+
+	if (unlikely(i < nb_mbufs)) {
+		uint16_t idx = next_to_use;
+
+		PMD_RX_LOG_LINE(WARNING,
+			"Refilled Rx queue[%d] with only %d/%d recycled buffers",
+			rxq->id, i, nb_mbufs);
+		for (; i < nb_mbufs; i++) {
+			rte_mbuf_raw_free(rxq->rx_refill_buffer[idx]);
+			idx = ENA_IDX_NEXT_MASKED(idx, rxq->size_mask);
+		}
+		++rxq->rx_stats.refill_partial;
+	}
+
+	if (likely(next_to_use != rxq->next_to_use)) {
+		ena_com_write_sq_doorbell(rxq->ena_com_io_sq);
+		rxq->next_to_use = next_to_use;
+	}
+}
+
+uint16_t eth_ena_xmit_pkts(void *tx_queue, struct rte_mbuf **tx_pkts,
+			   uint16_t nb_pkts)
 {
 	struct ena_ring *tx_ring = (struct ena_ring *)(tx_queue);
 	int available_desc;
@@ -3316,8 +3833,21 @@ static void ena_copy_customer_metrics(struct ena_adapter *adapter, uint64_t *buf
 					     size_t num_metrics)
 {
 	struct ena_com_dev *ena_dev = &adapter->ena_dev;
+	struct ena_stats_snapshot snapshot;
 	int rc;
 
+	if (unlikely(num_metrics > ENA_MAX_CUSTOMER_METRICS)) {
+		PMD_DRV_LOG_LINE(ERR, "Too many customer metrics requested: %zu",
+			num_metrics);
+		num_metrics = ENA_MAX_CUSTOMER_METRICS;
+	}
+
+	if (ena_stats_snapshot_get(adapter, &snapshot)) {
+		rte_memcpy(buf, snapshot.metrics_stats,
+			   num_metrics * sizeof(uint64_t));
+		return;
+	}
+
 	if (ena_com_get_cap(ena_dev, ENA_ADMIN_CUSTOMER_METRICS)) {
 		if (num_metrics != ENA_STATS_ARRAY_METRICS) {
 			PMD_DRV_LOG_LINE(ERR, "Detected discrepancy in the number of customer metrics");
@@ -3358,11 +3888,17 @@ static void ena_copy_customer_metrics(struct ena_adapter *adapter, uint64_t *buf
 static void ena_copy_ena_srd_info(struct ena_adapter *adapter,
 		struct ena_stats_srd *srd_info)
 {
+	struct ena_stats_snapshot snapshot;
 	int rc;
 
 	if (!ena_com_get_cap(&adapter->ena_dev, ENA_ADMIN_ENA_SRD_INFO))
 		return;
 
+	if (ena_stats_snapshot_get(adapter, &snapshot)) {
+		*srd_info = snapshot.srd_stats;
+		return;
+	}
+
 	rte_spinlock_lock(&adapter->admin_lock);
 	rc = ENA_PROXY(adapter,
 		       ena_com_get_ena_srd_info,
@@ -3376,6 +3912,76 @@ static void ena_copy_ena_srd_info(struct ena_adapter *adapter,
 	}
 }
 
+/*
+ * Read the device stats published by the primary process. It is used only by
+ * the secondary processes and it returns false if the snapshot is missing or
+ * outdated - in that case the stats should be obtained through the IPC. The
+ * reads keep the snapshot refreshed, so the primary doesn't query the device
+ * stats periodically if no secondary process uses them.
+ */
+static bool ena_stats_snapshot_get(struct ena_adapter *adapter,
+				   struct ena_stats_snapshot *snapshot)
+{
+	struct ena_stats_shared *stats_shared = &adapter->stats_shared;
+	uint64_t now, last_read;
+	uint32_t sn;
+
+	if (rte_eal_process_type() == RTE_PROC_PRIMARY)
+		return false;
+
+	/* Record the read at most once per second, as the watchdog period */
+	now = rte_get_timer_cycles();
+	last_read = rte_atomic_load_explicit(&stats_shared->last_read,
+					     rte_memory_order_relaxed);
+	if (now - last_read >= rte_get_timer_hz())
+		rte_atomic_store_explicit(&stats_shared->last_read, now,
+					  rte_memory_order_relaxed);
+
+	do {
+		sn = rte_seqlock_read_begin(&stats_shared->lock);
+		*snapshot = stats_shared->snapshot;
+	} while (rte_seqlock_read_retry(&stats_shared->lock, sn));
+
+	return snapshot->timestamp != 0 &&
+		rte_get_timer_cycles() - snapshot->timestamp < ENA_STATS_SNAPSHOT_MAX_AGE;
+}
+
+/* Publish the device stats for the secondary processes, if they use them */
+static void ena_stats_snapshot_update(struct ena_adapter *adapter)
+{
+	struct ena_stats_shared *stats_shared = &adapter->stats_shared;
+	struct ena_stats_snapshot snapshot;
+	uint64_t last_read;
+	int rc;
+
+	last_read = rte_atomic_load_explicit(&stats_shared->last_read,
+					     rte_memory_order_relaxed);
+	if (last_read == 0 ||
+	    rte_get_timer_cycles() - last_read >= ENA_STATS_SNAPSHOT_IDLE_TIME)
+		return;
+
+	memset(&snapshot, 0, sizeof(snapshot));
+
+	rte_spinlock_lock(&adapter->admin_lock);
+	rc = ena_com_get_dev_basic_stats(&adapter->ena_dev,
+					 &snapshot.basic_stats);
+	rte_spinlock_unlock(&adapter->admin_lock);
+	if (unlikely(rc != 0)) {
+		PMD_DRV_LOG_LINE(WARNING,
+			"Failed to get the stats snapshot, rc: %d", rc);
+		return;
+	}
+
+	ena_copy_customer_metrics(adapter, snapshot.metrics_stats,
+				  adapter->metrics_num);
+	ena_copy_ena_srd_info(adapter, &snapshot.srd_stats);
+	snapshot.timestamp = rte_get_timer_cycles();
+
+	rte_seqlock_write_lock(&stats_shared->lock);
+	stats_shared->snapshot = snapshot;
+	rte_seqlock_write_unlock(&stats_shared->lock);
+}
+
 /**
  * DPDK callback to retrieve names of extended device statistics
  *
@@ -3661,7 +4267,7 @@ static int ena_xstats_get_by_id(struct rte_eth_dev *dev,
 				was_srd_info_copied = true;
 				ena_copy_ena_srd_info(adapter, &srd_info);
 			}
-			values[i] = *((uint64_t *)&adapter->srd_stats + id);
+			values[i] = *((uint64_t *)&srd_info + id);
 			++valid;
 			continue;
 		}
@@ -3746,6 +4352,16 @@ static int ena_process_uint_devarg(const char *key,
 				uint64_value);
 				adapter->control_path_poll_interval = uint64_value * USEC_PER_MSEC;
 		}
+	} else if (strcmp(key, ENA_DEVARG_CONTROL_PATH_SERVICE) == 0) {
+		if (uint64_value > 1) {
+			PMD_INIT_LOG_LINE(ERR,
+				"Invalid value: '%s' for key '%s'. Valid: [0-1]",
+				value, key);
+			return -EINVAL;
+		}
+		adapter->control_path_service = uint64_value != 0;
+		PMD_INIT_LOG_LINE(INFO, "Control path service is %s.",
+			adapter->control_path_service ? "enabled" : "disabled");
 	}
 
 	return 0;
@@ -3777,6 +4393,7 @@ static int ena_parse_devargs(struct ena_adapter *adapter, struct rte_devargs *de
 		ENA_DEVARG_LLQ_POLICY,
 		ENA_DEVARG_MISS_TXC_TO,
 		ENA_DEVARG_CONTROL_PATH_POLL_INTERVAL,
+		ENA_DEVARG_CONTROL_PATH_SERVICE,
 		NULL,
 	};
 	struct rte_kvargs *kvlist;
@@ -3803,6 +4420,10 @@ static int ena_parse_devargs(struct ena_adapter *adapter, struct rte_devargs *de
 		ena_process_uint_devarg, adapter);
 	if (rc != 0)
 		goto exit;
+	rc = rte_kvargs_process(kvlist, ENA_DEVARG_CONTROL_PATH_SERVICE,
+		ena_process_uint_devarg, adapter);
+	if (rc != 0)
+		goto exit;
 
 exit:
 	rte_kvargs_free(kvlist);
@@ -3905,6 +4526,127 @@ static int ena_rx_queue_intr_disable(struct rte_eth_dev *dev,
 	return 0;
 }
 
+#define ENA_MONITOR_EXPECTED_IDX	0
+#define ENA_MONITOR_MASK_IDX		1
+
+static int ena_monitor_callback(const uint64_t value,
+				const uint64_t opaque[RTE_POWER_MONITOR_OPAQUE_SZ])
+{
+	const uint64_t expected = opaque[ENA_MONITOR_EXPECTED_IDX];
+	const uint64_t mask = opaque[ENA_MONITOR_MASK_IDX];
+
+	/* The phase bit matches - the completion is ready, so abort the sleep */
+	return (value & mask) == expected ? -1 : 0;
+}
+
+/*
+ * Monitor the status of the next Rx completion descriptor. The device flips
+ * its phase bit once the descriptor is written, the same way as it's checked
+ * by the ena_com_get_next_rx_cdesc().
+ */
+static int ena_get_monitor_addr(void *rx_queue,
+				struct rte_power_monitor_cond *pmc)
+{
+	struct ena_ring *rxq = (struct ena_ring *)rx_queue;
+	struct ena_com_io_cq *io_cq = rxq->ena_com_io_cq;
+	struct ena_eth_io_rx_cdesc_base *cdesc;
+
+	cdesc = ena_com_rx_cdesc_idx_to_ptr(io_cq, io_cq->head);
+
+	pmc->addr = &cdesc->status;
+	pmc->opaque[ENA_MONITOR_EXPECTED_IDX] =
+		(uint64_t)io_cq->phase << ENA_ETH_IO_RX_CDESC_BASE_PHASE_SHIFT;
+	pmc->opaque[ENA_MONITOR_MASK_IDX] = ENA_ETH_IO_RX_CDESC_BASE_PHASE_MASK;
+	pmc->fn = ena_monitor_callback;
+	pmc->size = sizeof(cdesc->status);
+
+	return 0;
+}
+
+/*
+ * Check if the Rx completion descriptor located offset entries after the CQ
+ * head was already written by the device.
+ */
+static bool ena_rx_cdesc_is_done(struct ena_com_io_cq *io_cq, uint16_t offset)
+{
+	struct ena_eth_io_rx_cdesc_base *cdesc;
+	uint16_t head_masked = io_cq->head & (io_cq->q_depth - 1);
+	uint8_t expected_phase = io_cq->phase;
+
+	/* The phase is flipped each time the CQ wraps around */
+	if (head_masked + offset >= io_cq->q_depth)
+		expected_phase ^= 1;
+
+	cdesc = ena_com_rx_cdesc_idx_to_ptr(io_cq, io_cq->head + offset);
+
+	return ENA_FIELD_GET(READ_ONCE32(cdesc->status),
+			     ENA_ETH_IO_RX_CDESC_BASE_PHASE_MASK,
+			     ENA_ETH_IO_RX_CDESC_BASE_PHASE_SHIFT) == expected_phase;
+}
+
+/*
+ * The descriptors of the partially fetched packet were already consumed from
+ * the CQ, but they're still accounted as used in the SQ, so they're counted
+ * as done before the ones starting from the CQ head.
+ */
+static int ena_rx_queue_count(void *rx_queue)
+{
+	struct ena_ring *rx_ring = (struct ena_ring *)rx_queue;
+	struct ena_com_io_cq *io_cq = rx_ring->ena_com_io_cq;
+	uint16_t partial = io_cq->cur_rx_pkt_cdesc_count;
+	uint16_t descs_in_use, count;
+
+	descs_in_use = rx_ring->ring_size -
+		ena_com_free_q_entries(rx_ring->ena_com_io_sq) - 1;
+
+	for (count = partial; count < descs_in_use; count++) {
+		if (!ena_rx_cdesc_is_done(io_cq, count - partial))
+			break;
+	}
+
+	return count;
+}
+
+static int ena_rx_descriptor_status(void *rx_queue, uint16_t offset)
+{
+	struct ena_ring *rx_ring = (struct ena_ring *)rx_queue;
+	struct ena_com_io_cq *io_cq = rx_ring->ena_com_io_cq;
+	uint16_t partial = io_cq->cur_rx_pkt_cdesc_count;
+	uint16_t descs_in_use;
+
+	if (unlikely(offset >= rx_ring->ring_size))
+		return -EINVAL;
+
+	descs_in_use = rx_ring->ring_size -
+		ena_com_free_q_entries(rx_ring->ena_com_io_sq) - 1;
+
+	if (offset >= descs_in_use)
+		return RTE_ETH_RX_DESC_UNAVAIL;
+
+	if (offset < partial || ena_rx_cdesc_is_done(io_cq, offset - partial))
+		return RTE_ETH_RX_DESC_DONE;
+
+	return RTE_ETH_RX_DESC_AVAIL;
+}
+
+/*
+ * The Tx completions can arrive out of order and the SQ entries are released
+ * only by the Tx cleanup, so the descriptor is reported as done only if its SQ
+ * entry can be reused. In the LLQ mode the SQ entry is a single LLQ line.
+ */
+static int ena_tx_descriptor_status(void *tx_queue, uint16_t offset)
+{
+	struct ena_ring *tx_ring = (struct ena_ring *)tx_queue;
+
+	if (unlikely(offset >= tx_ring->ring_size))
+		return -EINVAL;
+
+	if (offset < ena_com_free_q_entries(tx_ring->ena_com_io_sq))
+		return RTE_ETH_TX_DESC_DONE;
+
+	return RTE_ETH_TX_DESC_FULL;
+}
+
 static int ena_configure_aenq(struct ena_adapter *adapter)
 {
 	uint32_t aenq_groups = adapter->all_aenq_groups;
@@ -4023,8 +4765,9 @@ RTE_PMD_REGISTER_PCI_TABLE(net_ena, pci_id_ena_map);
 RTE_PMD_REGISTER_KMOD_DEP(net_ena, "* igb_uio | uio_pci_generic | vfio-pci");
 RTE_PMD_REGISTER_PARAM_STRING(net_ena,
 	ENA_DEVARG_LLQ_POLICY "=<0|1|2|3> "
-	ENA_DEVARG_MISS_TXC_TO "=<uint>"
-	ENA_DEVARG_CONTROL_PATH_POLL_INTERVAL "=<0-1000>");
+	ENA_DEVARG_MISS_TXC_TO "=<uint> "
+	ENA_DEVARG_CONTROL_PATH_POLL_INTERVAL "=<0-1000> "
+	ENA_DEVARG_CONTROL_PATH_SERVICE "=<0|1>");
 RTE_LOG_REGISTER_SUFFIX(ena_logtype_init, init, NOTICE);
 RTE_LOG_REGISTER_SUFFIX(ena_logtype_driver, driver, NOTICE);
 #ifdef RTE_ETHDEV_DEBUG_RX
@@ -16,6 +16,7 @@
 #include <rte_timer.h>
 #include <rte_dev.h>
 #include <rte_net.h>
+#include <rte_seqlock.h>
 
 #include "ena_com.h"
 
@@ -34,6 +35,9 @@
 
 #define ENA_MIN_MTU		128
 
+/* Max LLQ entry size supported by the simple Tx path */
+#define ENA_TX_SIMPLE_MAX_ENTRY_SIZE	256
+
 #define ENA_MMIO_DISABLE_REG_READ	BIT(0)
 
 #define ENA_WD_TIMEOUT_SEC	3
@@ -46,6 +50,14 @@
 
 #define ENA_MAX_CONTROL_PATH_POLL_INTERVAL_MSEC 1000
 
+/*
+ * The stats snapshot is refreshed by the watchdog, which runs every second.
+ * Older snapshot means that the watchdog isn't running (the port is stopped).
+ */
+#define ENA_STATS_SNAPSHOT_MAX_AGE	(2 * rte_get_timer_hz())
+/* The snapshot isn't refreshed if no secondary process read it for this long */
+#define ENA_STATS_SNAPSHOT_IDLE_TIME	(30 * rte_get_timer_hz())
+
 /* While processing submitted and completed descriptors (rx and tx path
  * respectively) in a loop it is desired to:
  *  - perform batch submissions while populating submission queue
@@ -110,6 +122,18 @@ struct ena_rx_buffer {
 	struct ena_com_buf ena_buf;
 };
 
+/* Rx flow steering rule created through the rte_flow API */
+struct rte_flow {
+	TAILQ_ENTRY(rte_flow) next;
+	struct ena_com_flow_steering_rule_params rule_params;
+	/* Location of the rule in the device flow steering table */
+	uint16_t rule_idx;
+	/* The rule isn't programmed to the device, as restoring it failed */
+	bool stale;
+};
+
+TAILQ_HEAD(ena_flow_list, rte_flow);
+
 struct ena_calc_queue_size_ctx {
 	struct ena_com_dev_get_features_ctx *get_feat_ctx;
 	struct ena_com_dev *ena_dev;
@@ -194,11 +218,23 @@ struct __rte_cache_aligned ena_ring {
 
 	bool disable_meta_caching;
 
+	/* Template of the mbuf rearm data, written on the Rx refill */
+	uint64_t mbuf_initializer;
+	/* Tx queue configuration allows using the simple Tx path */
+	bool tx_simple;
+
 	union {
 		struct ena_stats_rx rx_stats;
 		struct ena_stats_tx tx_stats;
 	};
 
+	/*
+	 * Per queue parts of the driver statistics, updated only by the queue
+	 * owner and aggregated by ena_stats_get().
+	 */
+	u64 ierrors;
+	u64 rx_nombuf;
+
 	unsigned int numa_socket_id;
 
 	uint32_t missing_tx_completion_threshold;
@@ -214,9 +250,7 @@ enum ena_adapter_state {
 };
 
 struct ena_driver_stats {
-	rte_atomic64_t ierrors;
 	rte_atomic64_t oerrors;
-	rte_atomic64_t rx_nombuf;
 	u64 rx_drops;
 };
 
@@ -279,6 +313,29 @@ struct ena_stats_srd {
 	uint64_t ena_srd_resource_utilization;
 };
 
+struct ena_stats_snapshot {
+	struct ena_admin_basic_stats basic_stats;
+	uint64_t metrics_stats[ENA_MAX_CUSTOMER_METRICS];
+	struct ena_stats_srd srd_stats;
+	/* Time of the snapshot in timer cycles, 0 if it was never taken */
+	uint64_t timestamp;
+};
+
+/*
+ * Device statistics published by the primary process, so the secondary
+ * processes can read them locklessly instead of asking the primary over IPC.
+ */
+struct ena_stats_shared {
+	rte_seqlock_t lock;
+	/*
+	 * Time of the last read by a secondary process in timer cycles. While it
+	 * is recent, the primary refreshes the snapshot on every watchdog tick,
+	 * so readers polling at any rate find it up to date.
+	 */
+	RTE_ATOMIC(uint64_t) last_read;
+	struct ena_stats_snapshot snapshot;
+};
+
 struct ena_offloads {
 	uint32_t tx_offloads;
 	uint32_t rx_offloads;
@@ -335,6 +392,9 @@ struct ena_adapter {
 
 	u32 indirect_table[ENA_RX_RSS_TABLE_SIZE];
 
+	/* Flow steering rules, protected by the admin_lock */
+	struct ena_flow_list flow_list;
+
 	uint32_t all_aenq_groups;
 	uint32_t active_aenq_groups;
 
@@ -351,6 +411,14 @@ struct ena_adapter {
 	/* Time (in microseconds) of the control path queues monitoring interval */
 	uint64_t control_path_poll_interval;
 
+	/* Control path executed by the rte_service instead of interrupts/alarm */
+	bool control_path_service;
+	uint32_t control_path_service_id;
+	/* Keep the service registered on close, as the device is being reset */
+	bool control_path_service_keep;
+	/* Next watchdog execution time (in timer cycles) in the service mode */
+	uint64_t timer_wd_deadline;
+
 	/*
 	 * Helper variables for holding the information about the supported
 	 * metrics.
@@ -358,6 +426,8 @@ struct ena_adapter {
 	alignas(RTE_CACHE_LINE_SIZE) uint64_t metrics_stats[ENA_MAX_CUSTOMER_METRICS];
 	uint16_t metrics_num;
 	alignas(RTE_CACHE_LINE_SIZE) struct ena_stats_srd srd_stats;
+
+	alignas(RTE_CACHE_LINE_SIZE) struct ena_stats_shared stats_shared;
 };
 
 int ena_mp_indirect_table_set(struct ena_adapter *adapter);
@@ -375,4 +445,34 @@ int ena_rss_hash_conf_get(struct rte_eth_dev *dev,
 			  struct rte_eth_rss_conf *rss_conf);
 int ena_rss_configure(struct ena_adapter *adapter);
 
+int ena_flow_ops_get(struct rte_eth_dev *dev, const struct rte_flow_ops **ops);
+void ena_flow_list_save(struct ena_adapter *adapter,
+			struct ena_flow_list *flow_list);
+int ena_flow_list_restore(struct ena_adapter *adapter,
+			  struct ena_flow_list *flow_list);
+void ena_flow_list_invalidate(struct ena_adapter *adapter,
+			      struct ena_flow_list *flow_list);
+void ena_flow_list_release(struct ena_adapter *adapter);
+
+uint16_t eth_ena_recv_pkts(void *rx_queue, struct rte_mbuf **rx_pkts,
+			   uint16_t nb_pkts);
+int ena_populate_rx_queue(struct ena_ring *rxq, unsigned int count);
+uint16_t eth_ena_xmit_pkts(void *tx_queue, struct rte_mbuf **tx_pkts,
+			   uint16_t nb_pkts);
+int ena_tx_cleanup(void *txp, uint32_t free_pkt_cnt);
+
+#ifdef ENA_VEC_SUPPORT
+#if defined(RTE_ARCH_X86)
+#define ENA_VEC_BURST_MODE_INFO "Vector SSE"
+#else
+#define ENA_VEC_BURST_MODE_INFO "Vector Neon"
+#endif
+
+bool ena_rx_vec_supported(struct ena_ring *rx_ring);
+uint16_t ena_recv_pkts_vec(void *rx_queue, struct rte_mbuf **rx_pkts,
+			   uint16_t nb_pkts);
+uint16_t ena_xmit_pkts_simple(void *tx_queue, struct rte_mbuf **tx_pkts,
+			      uint16_t nb_pkts);
+#endif /* ENA_VEC_SUPPORT */
+
 #endif /* _ENA_ETHDEV_H_ */
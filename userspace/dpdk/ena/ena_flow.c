@@ -0,0 +1,660 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) Amazon.com, Inc. or its affiliates.
+ * All rights reserved.
+ */
+
+#include <rte_flow.h>
+#include <rte_flow_driver.h>
+#include <rte_malloc.h>
+
+#include "ena_ethdev.h"
+#include "ena_logs.h"
+
+#include <ena_admin_defs.h>
+
+/*
+ * The device steers the packets only by the L3/L4 5-tuple fields, so only
+ * those fields can be set in the patterns masks. The L2 header can be a part
+ * of the pattern, but it cannot be matched on.
+ */
+static const struct rte_flow_item_eth ena_flow_eth_mask;
+
+static const struct rte_flow_item_ipv4 ena_flow_ipv4_mask = {
+	.hdr = {
+		.type_of_service = 0xff,
+		.src_addr = RTE_BE32(0xffffffff),
+		.dst_addr = RTE_BE32(0xffffffff),
+	},
+};
+
+static const struct rte_flow_item_ipv6 ena_flow_ipv6_mask = {
+	.hdr = {
+		.src_addr = RTE_IPV6_MASK_FULL,
+		.dst_addr = RTE_IPV6_MASK_FULL,
+	},
+};
+
+static const struct rte_flow_item_tcp ena_flow_tcp_mask = {
+	.hdr = {
+		.src_port = RTE_BE16(0xffff),
+		.dst_port = RTE_BE16(0xffff),
+	},
+};
+
+static const struct rte_flow_item_udp ena_flow_udp_mask = {
+	.hdr = {
+		.src_port = RTE_BE16(0xffff),
+		.dst_port = RTE_BE16(0xffff),
+	},
+};
+
+static int ena_flow_validate(struct rte_eth_dev *dev,
+			     const struct rte_flow_attr *attr,
+			     const struct rte_flow_item pattern[],
+			     const struct rte_flow_action actions[],
+			     struct rte_flow_error *error);
+static struct rte_flow *ena_flow_create(struct rte_eth_dev *dev,
+					const struct rte_flow_attr *attr,
+					const struct rte_flow_item pattern[],
+					const struct rte_flow_action actions[],
+					struct rte_flow_error *error);
+static int ena_flow_destroy(struct rte_eth_dev *dev,
+			    struct rte_flow *flow,
+			    struct rte_flow_error *error);
+static int ena_flow_flush(struct rte_eth_dev *dev,
+			  struct rte_flow_error *error);
+
+static const struct rte_flow_ops ena_flow_ops = {
+	.validate = ena_flow_validate,
+	.create   = ena_flow_create,
+	.destroy  = ena_flow_destroy,
+	.flush    = ena_flow_flush,
+};
+
+static bool ena_flow_mask_supported(const void *mask,
+				    const void *supported_mask,
+				    size_t size)
+{
+	const uint8_t *m = mask;
+	const uint8_t *s = supported_mask;
+	size_t i;
+
+	for (i = 0; i < size; i++)
+		if (m[i] & ~s[i])
+			return false;
+
+	return true;
+}
+
+/*
+ * Validate the generic item fields and return the mask which should be used
+ * for the item. If the item doesn't have the spec, it matches any header of
+ * its type and the returned mask is NULL.
+ */
+static int ena_flow_item_mask_get(const struct rte_flow_item *item,
+				  const void *default_mask,
+				  const void *supported_mask,
+				  size_t size,
+				  const void **mask,
+				  struct rte_flow_error *error)
+{
+	*mask = NULL;
+
+	if (item->last != NULL)
+		return rte_flow_error_set(error, ENOTSUP,
+			RTE_FLOW_ERROR_TYPE_ITEM_LAST, item,
+			"Ranges are not supported");
+
+	if (item->spec == NULL) {
+		if (item->mask != NULL)
+			return rte_flow_error_set(error, EINVAL,
+				RTE_FLOW_ERROR_TYPE_ITEM_MASK, item,
+				"Mask cannot be set without the spec");
+		return 0;
+	}
+
+	*mask = item->mask != NULL ? item->mask : default_mask;
+	if (!ena_flow_mask_supported(*mask, supported_mask, size))
+		return rte_flow_error_set(error, ENOTSUP,
+			RTE_FLOW_ERROR_TYPE_ITEM_MASK, item,
+			"Matching on the requested fields is not supported");
+
+	return 0;
+}
+
+static const struct rte_flow_item *
+ena_flow_item_next(const struct rte_flow_item *item)
+{
+	while (item->type == RTE_FLOW_ITEM_TYPE_VOID)
+		++item;
+
+	return item;
+}
+
+static void ena_flow_ip_fill(uint8_t *ip, uint8_t *ip_mask,
+			     const void *spec, const void *mask, size_t size)
+{
+	const uint8_t *s = spec;
+	const uint8_t *m = mask;
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		ip[i] = s[i] & m[i];
+		ip_mask[i] = m[i];
+	}
+}
+
+static int ena_flow_parse_ipv4(const struct rte_flow_item *item,
+			       struct ena_admin_flow_steering_rule_params *flow_params,
+			       struct rte_flow_error *error)
+{
+	const struct rte_flow_item_ipv4 *spec = item->spec;
+	const struct rte_flow_item_ipv4 *mask;
+	int rc;
+
+	rc = ena_flow_item_mask_get(item, &rte_flow_item_ipv4_mask,
+		&ena_flow_ipv4_mask, sizeof(ena_flow_ipv4_mask),
+		(const void **)&mask, error);
+	if (rc != 0 || mask == NULL)
+		return rc;
+
+	ena_flow_ip_fill(flow_params->src_ip, flow_params->src_ip_mask,
+		&spec->hdr.src_addr, &mask->hdr.src_addr,
+		sizeof(spec->hdr.src_addr));
+	ena_flow_ip_fill(flow_params->dst_ip, flow_params->dst_ip_mask,
+		&spec->hdr.dst_addr, &mask->hdr.dst_addr,
+		sizeof(spec->hdr.dst_addr));
+	flow_params->tos = spec->hdr.type_of_service &
+		mask->hdr.type_of_service;
+	flow_params->tos_mask = mask->hdr.type_of_service;
+
+	return 0;
+}
+
+static int ena_flow_parse_ipv6(const struct rte_flow_item *item,
+			       struct ena_admin_flow_steering_rule_params *flow_params,
+			       struct rte_flow_error *error)
+{
+	const struct rte_flow_item_ipv6 *spec = item->spec;
+	const struct rte_flow_item_ipv6 *mask = item->mask;
+	int rc;
+
+	/* The device matches the ToS of IPv4 packets only */
+	if (mask != NULL &&
+	    (mask->hdr.vtc_flow & RTE_BE32(RTE_IPV6_HDR_TC_MASK)) != 0)
+		return rte_flow_error_set(error, ENOTSUP,
+			RTE_FLOW_ERROR_TYPE_ITEM, item,
+			"Matching on the IPv6 traffic class is not supported");
+
+	rc = ena_flow_item_mask_get(item, &rte_flow_item_ipv6_mask,
+		&ena_flow_ipv6_mask, sizeof(ena_flow_ipv6_mask),
+		(const void **)&mask, error);
+	if (rc != 0 || mask == NULL)
+		return rc;
+
+	ena_flow_ip_fill(flow_params->src_ip, flow_params->src_ip_mask,
+		&spec->hdr.src_addr, &mask->hdr.src_addr,
+		sizeof(spec->hdr.src_addr));
+	ena_flow_ip_fill(flow_params->dst_ip, flow_params->dst_ip_mask,
+		&spec->hdr.dst_addr, &mask->hdr.dst_addr,
+		sizeof(spec->hdr.dst_addr));
+
+	return 0;
+}
+
+/* The device expects the L4 ports in the host byte order */
+static void ena_flow_ports_fill(struct ena_admin_flow_steering_rule_params *flow_params,
+				rte_be16_t src_port, rte_be16_t src_port_mask,
+				rte_be16_t dst_port, rte_be16_t dst_port_mask)
+{
+	flow_params->src_port = rte_be_to_cpu_16(src_port & src_port_mask);
+	flow_params->src_port_mask = rte_be_to_cpu_16(src_port_mask);
+	flow_params->dst_port = rte_be_to_cpu_16(dst_port & dst_port_mask);
+	flow_params->dst_port_mask = rte_be_to_cpu_16(dst_port_mask);
+}
+
+static int ena_flow_parse_tcp(const struct rte_flow_item *item,
+			      struct ena_admin_flow_steering_rule_params *flow_params,
+			      struct rte_flow_error *error)
+{
+	const struct rte_flow_item_tcp *spec = item->spec;
+	const struct rte_flow_item_tcp *mask;
+	int rc;
+
+	rc = ena_flow_item_mask_get(item, &rte_flow_item_tcp_mask,
+		&ena_flow_tcp_mask, sizeof(ena_flow_tcp_mask),
+		(const void **)&mask, error);
+	if (rc != 0 || mask == NULL)
+		return rc;
+
+	ena_flow_ports_fill(flow_params,
+		spec->hdr.src_port, mask->hdr.src_port,
+		spec->hdr.dst_port, mask->hdr.dst_port);
+
+	return 0;
+}
+
+static int ena_flow_parse_udp(const struct rte_flow_item *item,
+			      struct ena_admin_flow_steering_rule_params *flow_params,
+			      struct rte_flow_error *error)
+{
+	const struct rte_flow_item_udp *spec = item->spec;
+	const struct rte_flow_item_udp *mask;
+	int rc;
+
+	rc = ena_flow_item_mask_get(item, &rte_flow_item_udp_mask,
+		&ena_flow_udp_mask, sizeof(ena_flow_udp_mask),
+		(const void **)&mask, error);
+	if (rc != 0 || mask == NULL)
+		return rc;
+
+	ena_flow_ports_fill(flow_params,
+		spec->hdr.src_port, mask->hdr.src_port,
+		spec->hdr.dst_port, mask->hdr.dst_port);
+
+	return 0;
+}
+
+/*
+ * The supported pattern is: [ETH] / IPV4|IPV6 / [TCP|UDP] / END, with the VOID
+ * items allowed anywhere. The flow type of the rule is determined by the L3
+ * and L4 items present in the pattern.
+ */
+static int ena_flow_parse_pattern(const struct rte_flow_item pattern[],
+				  struct ena_com_flow_steering_rule_params *rule_params,
+				  struct rte_flow_error *error)
+{
+	struct ena_admin_flow_steering_rule_params *flow_params =
+		&rule_params->flow_params;
+	const struct rte_flow_item *item;
+	const void *mask;
+	bool is_ipv6;
+	int rc;
+
+	if (pattern == NULL)
+		return rte_flow_error_set(error, EINVAL,
+			RTE_FLOW_ERROR_TYPE_ITEM_NUM, NULL,
+			"Pattern cannot be NULL");
+
+	item = ena_flow_item_next(pattern);
+	if (item->type == RTE_FLOW_ITEM_TYPE_ETH) {
+		rc = ena_flow_item_mask_get(item, &rte_flow_item_eth_mask,
+			&ena_flow_eth_mask, sizeof(ena_flow_eth_mask),
+			&mask, error);
+		if (rc != 0)
+			return rc;
+		item = ena_flow_item_next(item + 1);
+	}
+
+	switch (item->type) {
+	case RTE_FLOW_ITEM_TYPE_IPV4:
+		is_ipv6 = false;
+		rule_params->flow_type = ENA_ADMIN_FLOW_IPV4;
+		rc = ena_flow_parse_ipv4(item, flow_params, error);
+		break;
+	case RTE_FLOW_ITEM_TYPE_IPV6:
+		is_ipv6 = true;
+		rule_params->flow_type = ENA_ADMIN_FLOW_IPV6;
+		rc = ena_flow_parse_ipv6(item, flow_params, error);
+		break;
+	default:
+		return rte_flow_error_set(error, ENOTSUP,
+			RTE_FLOW_ERROR_TYPE_ITEM, item,
+			"Expected IPv4 or IPv6 item");
+	}
+	if (rc != 0)
+		return rc;
+
+	item = ena_flow_item_next(item + 1);
+	switch (item->type) {
+	case RTE_FLOW_ITEM_TYPE_TCP:
+		rule_params->flow_type = is_ipv6 ?
+			ENA_ADMIN_FLOW_IPV6_TCP : ENA_ADMIN_FLOW_IPV4_TCP;
+		rc = ena_flow_parse_tcp(item, flow_params, error);
+		break;
+	case RTE_FLOW_ITEM_TYPE_UDP:
+		rule_params->flow_type = is_ipv6 ?
+			ENA_ADMIN_FLOW_IPV6_UDP : ENA_ADMIN_FLOW_IPV4_UDP;
+		rc = ena_flow_parse_udp(item, flow_params, error);
+		break;
+	case RTE_FLOW_ITEM_TYPE_END:
+		return 0;
+	default:
+		return rte_flow_error_set(error, ENOTSUP,
+			RTE_FLOW_ERROR_TYPE_ITEM, item,
+			"Expected TCP or UDP item");
+	}
+	if (rc != 0)
+		return rc;
+
+	item = ena_flow_item_next(item + 1);
+	if (item->type != RTE_FLOW_ITEM_TYPE_END)
+		return rte_flow_error_set(error, ENOTSUP,
+			RTE_FLOW_ERROR_TYPE_ITEM, item,
+			"Only the 5-tuple can be matched");
+
+	return 0;
+}
+
+/* Only a single QUEUE action is supported */
+static int ena_flow_parse_actions(struct rte_eth_dev *dev,
+				  const struct rte_flow_action actions[],
+				  struct ena_com_flow_steering_rule_params *rule_params,
+				  struct rte_flow_error *error)
+{
+	const struct rte_flow_action_queue *queue = NULL;
+	const struct rte_flow_action *action;
+
+	if (actions == NULL)
+		return rte_flow_error_set(error, EINVAL,
+			RTE_FLOW_ERROR_TYPE_ACTION_NUM, NULL,
+			"Actions cannot be NULL");
+
+	for (action = actions; action->type != RTE_FLOW_ACTION_TYPE_END;
+	     action++) {
+		switch (action->type) {
+		case RTE_FLOW_ACTION_TYPE_VOID:
+			break;
+		case RTE_FLOW_ACTION_TYPE_QUEUE:
+			if (queue != NULL)
+				return rte_flow_error_set(error, ENOTSUP,
+					RTE_FLOW_ERROR_TYPE_ACTION, action,
+					"Only a single QUEUE action is supported");
+			queue = action->conf;
+			if (queue == NULL ||
+			    queue->index >= dev->data->nb_rx_queues)
+				return rte_flow_error_set(error, EINVAL,
+					RTE_FLOW_ERROR_TYPE_ACTION_CONF, action,
+					"Invalid Rx queue index");
+			break;
+		default:
+			return rte_flow_error_set(error, ENOTSUP,
+				RTE_FLOW_ERROR_TYPE_ACTION, action,
+				"Only the QUEUE action is supported");
+		}
+	}
+
+	if (queue == NULL)
+		return rte_flow_error_set(error, EINVAL,
+			RTE_FLOW_ERROR_TYPE_ACTION_NUM, actions,
+			"QUEUE action is required");
+
+	rule_params->qid = queue->index;
+
+	return 0;
+}
+
+static int ena_flow_parse(struct rte_eth_dev *dev,
+			  const struct rte_flow_attr *attr,
+			  const struct rte_flow_item pattern[],
+			  const struct rte_flow_action actions[],
+			  struct ena_com_flow_steering_rule_params *rule_params,
+			  struct rte_flow_error *error)
+{
+	struct ena_adapter *adapter = dev->data->dev_private;
+	int rc;
+
+	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
+		return rte_flow_error_set(error, EPERM,
+			RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+			"Flow rules cannot be managed by the secondary process");
+
+	if (adapter->ena_dev.flow_steering.tbl_size == 0)
+		return rte_flow_error_set(error, ENOTSUP,
+			RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+			"Flow steering is not supported by the device");
+
+	if (attr == NULL)
+		return rte_flow_error_set(error, EINVAL,
+			RTE_FLOW_ERROR_TYPE_ATTR, NULL,
+			"Attributes cannot be NULL");
+
+	if (!attr->ingress || attr->egress || attr->transfer)
+		return rte_flow_error_set(error, ENOTSUP,
+			RTE_FLOW_ERROR_TYPE_ATTR, attr,
+			"Only the ingress rules are supported");
+
+	if (attr->group != 0 || attr->priority != 0)
+		return rte_flow_error_set(error, ENOTSUP,
+			RTE_FLOW_ERROR_TYPE_ATTR, attr,
+			"Groups and priorities are not supported");
+
+	memset(rule_params, 0, sizeof(*rule_params));
+
+	rc = ena_flow_parse_pattern(pattern, rule_params, error);
+	if (rc != 0)
+		return rc;
+
+	return ena_flow_parse_actions(dev, actions, rule_params, error);
+}
+
+static int ena_flow_validate(struct rte_eth_dev *dev,
+			     const struct rte_flow_attr *attr,
+			     const struct rte_flow_item pattern[],
+			     const struct rte_flow_action actions[],
+			     struct rte_flow_error *error)
+{
+	struct ena_com_flow_steering_rule_params rule_params;
+
+	return ena_flow_parse(dev, attr, pattern, actions, &rule_params, error);
+}
+
+/* Return the lowest unused index of the device flow steering table */
+static int ena_flow_rule_idx_get(struct ena_com_dev *ena_dev, uint16_t *rule_idx)
+{
+	struct ena_com_flow_steering *flow_steering = &ena_dev->flow_steering;
+	uint16_t i;
+
+	for (i = 0; i < flow_steering->tbl_size; i++) {
+		if (!flow_steering->flow_steering_tbl[i].in_use) {
+			*rule_idx = i;
+			return 0;
+		}
+	}
+
+	return -ENOSPC;
+}
+
+static struct rte_flow *ena_flow_create(struct rte_eth_dev *dev,
+					const struct rte_flow_attr *attr,
+					const struct rte_flow_item pattern[],
+					const struct rte_flow_action actions[],
+					struct rte_flow_error *error)
+{
+	struct ena_adapter *adapter = dev->data->dev_private;
+	struct ena_com_dev *ena_dev = &adapter->ena_dev;
+	struct rte_flow *flow;
+	int rc;
+
+	flow = rte_zmalloc("ena_flow", sizeof(*flow), 0);
+	if (flow == NULL) {
+		rte_flow_error_set(error, ENOMEM,
+			RTE_FLOW_ERROR_TYPE_HANDLE, NULL,
+			"Failed to allocate the flow rule");
+		return NULL;
+	}
+
+	rc = ena_flow_parse(dev, attr, pattern, actions, &flow->rule_params,
+		error);
+	if (rc != 0)
+		goto err_free;
+
+	rte_spinlock_lock(&adapter->admin_lock);
+	rc = ena_flow_rule_idx_get(ena_dev, &flow->rule_idx);
+	if (unlikely(rc != 0)) {
+		rte_spinlock_unlock(&adapter->admin_lock);
+		rte_flow_error_set(error, ENOSPC,
+			RTE_FLOW_ERROR_TYPE_HANDLE, NULL,
+			"The flow steering table is full");
+		goto err_free;
+	}
+
+	rc = ena_com_flow_steering_add_rule(ena_dev, &flow->rule_params,
+		&flow->rule_idx);
+	if (unlikely(rc != 0)) {
+		rte_spinlock_unlock(&adapter->admin_lock);
+		rte_flow_error_set(error, -rc,
+			RTE_FLOW_ERROR_TYPE_HANDLE, NULL,
+			"Failed to add the flow steering rule");
+		goto err_free;
+	}
+	TAILQ_INSERT_TAIL(&adapter->flow_list, flow, next);
+	rte_spinlock_unlock(&adapter->admin_lock);
+
+	PMD_DRV_LOG_LINE(DEBUG, "Flow steering rule %u added for Rx queue %u",
+		flow->rule_idx, flow->rule_params.qid);
+
+	return flow;
+
+err_free:
+	rte_free(flow);
+	return NULL;
+}
+
+/* Must be called with the admin_lock held */
+static int ena_flow_remove(struct ena_adapter *adapter, struct rte_flow *flow)
+{
+	int rc;
+
+	if (!flow->stale) {
+		rc = ena_com_flow_steering_remove_rule(&adapter->ena_dev,
+			flow->rule_idx);
+		if (unlikely(rc != 0))
+			return rc;
+	}
+
+	TAILQ_REMOVE(&adapter->flow_list, flow, next);
+	rte_free(flow);
+
+	return 0;
+}
+
+static int ena_flow_destroy(struct rte_eth_dev *dev,
+			    struct rte_flow *flow,
+			    struct rte_flow_error *error)
+{
+	struct ena_adapter *adapter = dev->data->dev_private;
+	int rc;
+
+	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
+		return rte_flow_error_set(error, EPERM,
+			RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+			"Flow rules cannot be managed by the secondary process");
+
+	rte_spinlock_lock(&adapter->admin_lock);
+	rc = ena_flow_remove(adapter, flow);
+	rte_spinlock_unlock(&adapter->admin_lock);
+	if (unlikely(rc != 0))
+		return rte_flow_error_set(error, -rc,
+			RTE_FLOW_ERROR_TYPE_HANDLE, flow,
+			"Failed to remove the flow steering rule");
+
+	return 0;
+}
+
+static int ena_flow_flush(struct rte_eth_dev *dev,
+			  struct rte_flow_error *error)
+{
+	struct ena_adapter *adapter = dev->data->dev_private;
+	struct rte_flow *flow;
+	int rc = 0;
+
+	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
+		return rte_flow_error_set(error, EPERM,
+			RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+			"Flow rules cannot be managed by the secondary process");
+
+	rte_spinlock_lock(&adapter->admin_lock);
+	while ((flow = TAILQ_FIRST(&adapter->flow_list)) != NULL) {
+		rc = ena_flow_remove(adapter, flow);
+		if (unlikely(rc != 0))
+			break;
+	}
+	rte_spinlock_unlock(&adapter->admin_lock);
+	if (unlikely(rc != 0))
+		return rte_flow_error_set(error, -rc,
+			RTE_FLOW_ERROR_TYPE_HANDLE, flow,
+			"Failed to remove the flow steering rule");
+
+	return 0;
+}
+
+int ena_flow_ops_get(struct rte_eth_dev *dev __rte_unused,
+		     const struct rte_flow_ops **ops)
+{
+	*ops = &ena_flow_ops;
+
+	return 0;
+}
+
+/*
+ * The flow handles are owned by the application and must stay valid across
+ * the port reset, which reinitializes the adapter. Move them aside before the
+ * reset, so they can be programmed back to the device afterwards.
+ */
+void ena_flow_list_save(struct ena_adapter *adapter,
+			struct ena_flow_list *flow_list)
+{
+	TAILQ_INIT(flow_list);
+	TAILQ_CONCAT(flow_list, &adapter->flow_list, next);
+}
+
+int ena_flow_list_restore(struct ena_adapter *adapter,
+			  struct ena_flow_list *flow_list)
+{
+	struct ena_com_dev *ena_dev = &adapter->ena_dev;
+	struct rte_flow *flow;
+	int rc = 0;
+	int err;
+
+	if (TAILQ_EMPTY(flow_list))
+		return 0;
+
+	rte_spinlock_lock(&adapter->admin_lock);
+	TAILQ_FOREACH(flow, flow_list, next) {
+		if (ena_dev->flow_steering.tbl_size <= flow->rule_idx) {
+			err = -ENOTSUP;
+		} else {
+			err = ena_com_flow_steering_add_rule(ena_dev,
+				&flow->rule_params, &flow->rule_idx);
+		}
+		if (unlikely(err != 0)) {
+			/* Keep the handle, so it can be still destroyed */
+			PMD_DRV_LOG_LINE(ERR,
+				"Failed to restore flow steering rule %u, rc: %d",
+				flow->rule_idx, err);
+			rc = err;
+		}
+		flow->stale = err != 0;
+	}
+	TAILQ_CONCAT(&adapter->flow_list, flow_list, next);
+	rte_spinlock_unlock(&adapter->admin_lock);
+
+	return rc;
+}
+
+/*
+ * The device rules are lost if the port reset fails. Keep the handles as
+ * stale, so the application can still destroy them, and the next reset can
+ * program them again.
+ */
+void ena_flow_list_invalidate(struct ena_adapter *adapter,
+			      struct ena_flow_list *flow_list)
+{
+	struct rte_flow *flow;
+
+	TAILQ_FOREACH(flow, flow_list, next)
+		flow->stale = true;
+	TAILQ_CONCAT(&adapter->flow_list, flow_list, next);
+}
+
+/* Free the flow handles when the port is closed */
+void ena_flow_list_release(struct ena_adapter *adapter)
+{
+	struct rte_flow *flow;
+
+	while ((flow = TAILQ_FIRST(&adapter->flow_list)) != NULL) {
+		TAILQ_REMOVE(&adapter->flow_list, flow, next);
+		rte_free(flow);
+	}
+}
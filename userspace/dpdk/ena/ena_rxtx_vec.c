@@ -0,0 +1,556 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) Amazon.com, Inc. or its affiliates.
+ * All rights reserved.
+ */
+
+#include <rte_cpuflags.h>
+#include <rte_memcpy.h>
+#include <rte_vect.h>
+
+#include "ena_ethdev.h"
+#include "ena_logs.h"
+#include "ena_eth_com.h"
+
+/* Number of Rx completion descriptors handled in a single iteration */
+#define ENA_RX_VEC_BURST	4
+
+/*
+ * Status bits which must match for a completion to be handled by the vector
+ * path: the descriptor must belong to the current phase, carry a whole
+ * packet and must not have any of the MBZ bits set.
+ */
+#define ENA_RX_VEC_STATUS_CHECK_MASK			\
+	(ENA_ETH_IO_RX_CDESC_BASE_PHASE_MASK |		\
+	 ENA_ETH_IO_RX_CDESC_BASE_FIRST_MASK |		\
+	 ENA_ETH_IO_RX_CDESC_BASE_LAST_MASK |		\
+	 ENA_ETH_IO_RX_CDESC_BASE_MBZ7_MASK |		\
+	 ENA_ETH_IO_RX_CDESC_BASE_MBZ17_MASK)
+#define ENA_RX_VEC_STATUS_SINGLE_DESC			\
+	(ENA_ETH_IO_RX_CDESC_BASE_FIRST_MASK |		\
+	 ENA_ETH_IO_RX_CDESC_BASE_LAST_MASK)
+
+/*
+ * Bits 13-16 of the status (L3 csum error, L4 csum error, IPv4 fragment and
+ * L4 csum checked) are contiguous and are used directly as a part of the
+ * offloads lookup table index.
+ */
+#define ENA_RX_VEC_STATUS_FLAGS_SHIFT ENA_ETH_IO_RX_CDESC_BASE_L3_CSUM_ERR_SHIFT
+#define ENA_RX_VEC_STATUS_FLAGS_MASK			\
+	(ENA_ETH_IO_RX_CDESC_BASE_L3_CSUM_ERR_MASK |	\
+	 ENA_ETH_IO_RX_CDESC_BASE_L4_CSUM_ERR_MASK |	\
+	 ENA_ETH_IO_RX_CDESC_BASE_IPV4_FRAG_MASK |	\
+	 ENA_ETH_IO_RX_CDESC_BASE_L4_CSUM_CHECKED_MASK)
+
+#define ENA_RX_VEC_L3_NONE	0
+#define ENA_RX_VEC_L3_IPV4	1
+#define ENA_RX_VEC_L3_IPV6	2
+#define ENA_RX_VEC_L4_NONE	0
+#define ENA_RX_VEC_L4_TCP	1
+#define ENA_RX_VEC_L4_UDP	2
+
+#define ENA_RX_VEC_LUT_L4_SHIFT		2
+#define ENA_RX_VEC_LUT_FLAGS_SHIFT	4
+#define ENA_RX_VEC_LUT_SIZE		256
+
+/* The protocol index fields are 5 bits wide */
+#define ENA_RX_VEC_PROTO_IDX_NUM	32
+
+struct ena_rx_vec_offloads {
+	uint64_t ol_flags;
+	uint32_t packet_type;
+};
+
+static uint8_t ena_rx_vec_l3_class[ENA_RX_VEC_PROTO_IDX_NUM];
+static uint8_t ena_rx_vec_l4_class[ENA_RX_VEC_PROTO_IDX_NUM];
+static struct ena_rx_vec_offloads ena_rx_vec_lut[ENA_RX_VEC_LUT_SIZE];
+
+/*
+ * Precompute the packet type and the offload flags for every combination of
+ * the completion status bits, following the same rules as the scalar
+ * ena_rx_mbuf_prepare(). The RSS hash flag is always set for the valid L4
+ * packets and it's masked out in the Rx path if the offload isn't enabled.
+ */
+RTE_INIT(ena_rx_vec_lut_init)
+{
+	struct ena_rx_vec_offloads *entry;
+	bool l3_csum_err, l4_csum_err, frag, l4_csum_checked;
+	unsigned int key, l3, l4, flags;
+
+	ena_rx_vec_l3_class[ENA_ETH_IO_L3_PROTO_IPV4] = ENA_RX_VEC_L3_IPV4;
+	ena_rx_vec_l3_class[ENA_ETH_IO_L3_PROTO_IPV6] = ENA_RX_VEC_L3_IPV6;
+	ena_rx_vec_l4_class[ENA_ETH_IO_L4_PROTO_TCP] = ENA_RX_VEC_L4_TCP;
+	ena_rx_vec_l4_class[ENA_ETH_IO_L4_PROTO_UDP] = ENA_RX_VEC_L4_UDP;
+
+	for (key = 0; key < ENA_RX_VEC_LUT_SIZE; key++) {
+		entry = &ena_rx_vec_lut[key];
+		l3 = key & 0x3;
+		l4 = (key >> ENA_RX_VEC_LUT_L4_SHIFT) & 0x3;
+		flags = key >> ENA_RX_VEC_LUT_FLAGS_SHIFT;
+
+		l3_csum_err = !!(flags & BIT(0));
+		l4_csum_err = !!(flags & BIT(1));
+		frag = !!(flags & BIT(2));
+		l4_csum_checked = !!(flags & BIT(3));
+
+		if (l3 == ENA_RX_VEC_L3_IPV4) {
+			entry->packet_type |= RTE_PTYPE_L3_IPV4;
+			entry->ol_flags |= l3_csum_err ?
+				RTE_MBUF_F_RX_IP_CKSUM_BAD :
+				RTE_MBUF_F_RX_IP_CKSUM_GOOD;
+		} else if (l3 == ENA_RX_VEC_L3_IPV6) {
+			entry->packet_type |= RTE_PTYPE_L3_IPV6;
+		}
+
+		if (l4 == ENA_RX_VEC_L4_TCP)
+			entry->packet_type |= RTE_PTYPE_L4_TCP;
+		else if (l4 == ENA_RX_VEC_L4_UDP)
+			entry->packet_type |= RTE_PTYPE_L4_UDP;
+
+		if (l4 != ENA_RX_VEC_L4_NONE && !frag) {
+			if (l4_csum_checked)
+				entry->ol_flags |= l4_csum_err ?
+					RTE_MBUF_F_RX_L4_CKSUM_BAD :
+					RTE_MBUF_F_RX_L4_CKSUM_GOOD;
+			else
+				entry->ol_flags |= RTE_MBUF_F_RX_L4_CKSUM_UNKNOWN;
+
+			entry->ol_flags |= RTE_MBUF_F_RX_RSS_HASH;
+		} else {
+			entry->ol_flags |= RTE_MBUF_F_RX_L4_CKSUM_UNKNOWN;
+		}
+	}
+}
+
+static __rte_always_inline const struct ena_rx_vec_offloads *
+ena_rx_vec_offloads_get(uint32_t status)
+{
+	unsigned int key;
+
+	key = ena_rx_vec_l3_class[status &
+		ENA_ETH_IO_RX_CDESC_BASE_L3_PROTO_IDX_MASK];
+	key |= ena_rx_vec_l4_class[ENA_FIELD_GET(status,
+		ENA_ETH_IO_RX_CDESC_BASE_L4_PROTO_IDX_MASK,
+		ENA_ETH_IO_RX_CDESC_BASE_L4_PROTO_IDX_SHIFT)] <<
+		ENA_RX_VEC_LUT_L4_SHIFT;
+	key |= ((status & ENA_RX_VEC_STATUS_FLAGS_MASK) >>
+		ENA_RX_VEC_STATUS_FLAGS_SHIFT) << ENA_RX_VEC_LUT_FLAGS_SHIFT;
+
+	return &ena_rx_vec_lut[key];
+}
+
+/*
+ * Fill the mbuf fields starting from the packet_type (packet_type, pkt_len,
+ * data_len, vlan_tci and hash.rss) with a single 16B store, shuffling the
+ * length and the hash straight from the completion descriptor, which layout
+ * is:
+ *   [0-3] status, [4-5] length, [6-7] req_id, [8-11] hash, [12-13] sub_qid,
+ *   [14] offset, [15] reserved.
+ * The 8B rearm data (data_off, refcnt, nb_segs and port) is written at once,
+ * too.
+ */
+static __rte_always_inline void
+ena_rx_vec_mbuf_fill(struct rte_mbuf *mbuf,
+		     const struct ena_eth_io_rx_cdesc_base *cdesc,
+		     uint32_t packet_type,
+		     uint64_t rearm_data)
+{
+#if defined(RTE_ARCH_X86)
+	const __m128i shuf_msk = _mm_set_epi8(
+		11, 10, 9, 8,		/* hash.rss */
+		-1, -1,			/* vlan_tci */
+		5, 4,			/* data_len */
+		-1, -1, 5, 4,		/* pkt_len */
+		-1, -1, -1, -1);	/* packet_type */
+	__m128i desc, fields;
+
+	desc = _mm_loadu_si128((const __m128i *)cdesc);
+	fields = _mm_shuffle_epi8(desc, shuf_msk);
+	fields = _mm_insert_epi32(fields, (int)packet_type, 0);
+	_mm_storeu_si128((__m128i *)&mbuf->rx_descriptor_fields1, fields);
+#elif defined(RTE_ARCH_ARM64)
+	const uint8x16_t shuf_msk = {
+		0xFF, 0xFF, 0xFF, 0xFF,	/* packet_type */
+		4, 5, 0xFF, 0xFF,	/* pkt_len */
+		4, 5,			/* data_len */
+		0xFF, 0xFF,		/* vlan_tci */
+		8, 9, 10, 11		/* hash.rss */
+	};
+	uint32x4_t fields;
+	uint8x16_t desc;
+
+	desc = vld1q_u8((const uint8_t *)cdesc);
+	fields = vreinterpretq_u32_u8(vqtbl1q_u8(desc, shuf_msk));
+	fields = vsetq_lane_u32(packet_type, fields, 0);
+	vst1q_u32((uint32_t *)&mbuf->rx_descriptor_fields1, fields);
+#endif
+
+	*(uint64_t *)&mbuf->rearm_data = rearm_data;
+}
+
+bool ena_rx_vec_supported(struct ena_ring *rx_ring)
+{
+	if (rte_vect_get_max_simd_bitwidth() < RTE_VECT_SIMD_128)
+		return false;
+
+#if defined(RTE_ARCH_X86)
+	if (!rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE4_1))
+		return false;
+#endif
+
+	/* Descriptors are loaded and shuffled as a whole */
+	return rx_ring->ena_com_io_cq->cdesc_entry_size_in_bytes ==
+		sizeof(struct ena_eth_io_rx_cdesc_base);
+}
+
+/*
+ * Rx burst handling only the packets which fit in a single descriptor. Up to
+ * ENA_RX_VEC_BURST completions are validated at once and each of them is
+ * converted to the mbuf using vector loads and shuffles. Once the completion
+ * which cannot be handled this way is found (multi-descriptor packet, MBZ bits
+ * set or invalid req_id), the rest of the burst is passed to the scalar path,
+ * which is also responsible for the error handling.
+ */
+uint16_t ena_recv_pkts_vec(void *rx_queue, struct rte_mbuf **rx_pkts,
+			   uint16_t nb_pkts)
+{
+	struct ena_ring *rx_ring = (struct ena_ring *)(rx_queue);
+	struct ena_com_io_cq *io_cq = rx_ring->ena_com_io_cq;
+	struct ena_com_io_sq *io_sq = rx_ring->ena_com_io_sq;
+	struct ena_stats_rx *rx_stats = &rx_ring->rx_stats;
+	const struct ena_rx_vec_offloads *offloads;
+	struct ena_eth_io_rx_cdesc_base *cdesc;
+	uint32_t status[ENA_RX_VEC_BURST];
+	uint64_t rearm_data = rx_ring->mbuf_initializer;
+	uint64_t ol_flags_mask = ~0ULL;
+	uint64_t bytes = 0, errors = 0;
+	uint16_t next_to_clean = rx_ring->next_to_clean;
+	uint16_t q_depth = io_cq->q_depth;
+	uint16_t head = io_cq->head;
+	uint16_t head_masked, req_id;
+	uint16_t descs_in_use, completed = 0;
+	unsigned int free_queue_entries;
+	uint32_t expected;
+	bool fallback = false;
+	int i, n, ready;
+
+#ifdef RTE_ETHDEV_DEBUG_RX
+	/* Check adapter state */
+	if (unlikely(rx_ring->adapter->state != ENA_ADAPTER_STATE_RUNNING)) {
+		PMD_RX_LOG_LINE(ALERT,
+			"Trying to receive pkts while device is NOT running");
+		return 0;
+	}
+#endif
+
+	/* The packet which was partially fetched must be completed first */
+	if (unlikely(io_cq->cur_rx_pkt_cdesc_count != 0))
+		return eth_ena_recv_pkts(rx_queue, rx_pkts, nb_pkts);
+
+	if (!(rx_ring->offloads & RTE_ETH_RX_OFFLOAD_RSS_HASH))
+		ol_flags_mask = ~RTE_MBUF_F_RX_RSS_HASH;
+
+	descs_in_use = rx_ring->ring_size - ena_com_free_q_entries(io_sq) - 1;
+	nb_pkts = RTE_MIN(descs_in_use, nb_pkts);
+
+	while (completed < nb_pkts) {
+		head_masked = head & (q_depth - 1);
+		cdesc = (struct ena_eth_io_rx_cdesc_base *)
+			io_cq->cdesc_addr.virt_addr + head_masked;
+
+		/* Never cross the ring boundary, so the phase stays the same */
+		n = RTE_MIN(ENA_RX_VEC_BURST, nb_pkts - completed);
+		n = RTE_MIN(n, q_depth - head_masked);
+
+		expected = ENA_RX_VEC_STATUS_SINGLE_DESC |
+			((uint32_t)io_cq->phase << ENA_ETH_IO_RX_CDESC_BASE_PHASE_SHIFT);
+
+		for (ready = 0; ready < n; ready++) {
+			status[ready] = READ_ONCE32(cdesc[ready].status);
+			if ((status[ready] & ENA_RX_VEC_STATUS_CHECK_MASK) != expected)
+				break;
+		}
+
+		/*
+		 * The completion is owned by the driver, but it cannot be
+		 * processed in here.
+		 */
+		if (ready < n && (status[ready] & ENA_ETH_IO_RX_CDESC_BASE_PHASE_MASK) ==
+		    (expected & ENA_ETH_IO_RX_CDESC_BASE_PHASE_MASK))
+			fallback = true;
+
+		if (ready == 0)
+			break;
+
+		/* Read the rest of the descriptors after their status */
+		dma_rmb();
+
+		for (i = 0; i < ready; i++) {
+			struct ena_rx_buffer *rx_info;
+			struct rte_mbuf *mbuf;
+
+			req_id = cdesc[i].req_id;
+			if (unlikely(req_id >= q_depth)) {
+				fallback = true;
+				break;
+			}
+
+			rx_info = &rx_ring->rx_buffer_info[req_id];
+			mbuf = rx_info->mbuf;
+			RTE_ASSERT(mbuf != NULL);
+
+			rx_info->mbuf = NULL;
+			rx_ring->empty_rx_reqs[next_to_clean] = req_id;
+			next_to_clean = ENA_IDX_NEXT_MASKED(next_to_clean,
+							    rx_ring->size_mask);
+
+			offloads = ena_rx_vec_offloads_get(status[i]);
+			ena_rx_vec_mbuf_fill(mbuf, &cdesc[i],
+					     offloads->packet_type,
+					     rearm_data + cdesc[i].offset);
+			mbuf->ol_flags = offloads->ol_flags & ol_flags_mask;
+
+			if (unlikely(mbuf->ol_flags &
+				     (RTE_MBUF_F_RX_IP_CKSUM_BAD | RTE_MBUF_F_RX_L4_CKSUM_BAD))) {
+				++errors;
+				if ((mbuf->ol_flags & RTE_MBUF_F_RX_IP_CKSUM_MASK) ==
+				    RTE_MBUF_F_RX_IP_CKSUM_BAD)
+					++rx_stats->l3_csum_bad;
+				if ((mbuf->ol_flags & RTE_MBUF_F_RX_L4_CKSUM_MASK) ==
+				    RTE_MBUF_F_RX_L4_CKSUM_BAD)
+					++rx_stats->l4_csum_bad;
+			}
+			if ((mbuf->ol_flags & RTE_MBUF_F_RX_L4_CKSUM_MASK) ==
+			    RTE_MBUF_F_RX_L4_CKSUM_GOOD)
+				++rx_stats->l4_csum_good;
+
+			bytes += mbuf->pkt_len;
+			rx_pkts[completed++] = mbuf;
+		}
+
+		head += i;
+		io_sq->next_to_comp += i;
+		if (i > 0 && (head & (q_depth - 1)) == 0)
+			io_cq->phase ^= 1;
+
+		if (i < n)
+			break;
+	}
+
+	io_cq->head = head;
+	io_cq->cur_rx_pkt_cdesc_start_idx = head & (q_depth - 1);
+
+	rx_stats->cnt += completed;
+	rx_stats->bytes += bytes;
+	rx_ring->ierrors += errors;
+	rx_ring->next_to_clean = next_to_clean;
+
+	if (unlikely(fallback && completed < nb_pkts))
+		return completed + eth_ena_recv_pkts(rx_queue,
+						     rx_pkts + completed,
+						     nb_pkts - completed);
+
+	free_queue_entries = ena_com_free_q_entries(io_sq);
+
+	/* Burst refill to save doorbells, memory barriers, const interval */
+	if (free_queue_entries >= rx_ring->rx_free_thresh)
+		ena_populate_rx_queue(rx_ring, free_queue_entries);
+
+	return completed;
+}
+
+/* Zeroed meta descriptor, used when the meta caching is disabled */
+#define ENA_TX_SIMPLE_META_LEN_CTRL			\
+	(ENA_ETH_IO_TX_META_DESC_META_DESC_MASK |	\
+	 ENA_ETH_IO_TX_META_DESC_EXT_VALID_MASK |	\
+	 ENA_ETH_IO_TX_META_DESC_ETH_META_TYPE_MASK |	\
+	 ENA_ETH_IO_TX_META_DESC_FIRST_MASK |		\
+	 ENA_ETH_IO_TX_META_DESC_META_STORE_MASK)
+
+/*
+ * The scalar path reserves the space for the packet segments and 2 extra
+ * descriptors. Keep the same margin for the single segment packets.
+ */
+#define ENA_TX_SIMPLE_DESCS_RESERVED	3
+
+static __rte_always_inline void
+ena_tx_simple_store16(void *dst, uint32_t w0, uint32_t w1, uint32_t w2,
+		      uint32_t w3)
+{
+#if defined(RTE_ARCH_X86)
+	_mm_store_si128((__m128i *)dst, _mm_set_epi32(w3, w2, w1, w0));
+#elif defined(RTE_ARCH_ARM64)
+	const uint32_t words[4] = { w0, w1, w2, w3 };
+
+	vst1q_u32((uint32_t *)dst, vld1q_u32(words));
+#endif
+}
+
+/* Copy the whole LLQ entry to the device memory using 16B stores */
+static __rte_always_inline void
+ena_tx_simple_copy_line(void *dst, const void *src, uint16_t size)
+{
+	uint16_t i;
+
+	for (i = 0; i < size; i += 16) {
+#if defined(RTE_ARCH_X86)
+		_mm_storeu_si128((__m128i *)RTE_PTR_ADD(dst, i),
+			_mm_load_si128((const __m128i *)RTE_PTR_ADD(src, i)));
+#elif defined(RTE_ARCH_ARM64)
+		vst1q_u64((uint64_t *)RTE_PTR_ADD(dst, i),
+			  vld1q_u64((const uint64_t *)RTE_PTR_ADD(src, i)));
+#endif
+	}
+}
+
+/*
+ * Tx burst for the single segment packets without any offloads, used only in
+ * the LLQ mode. Each packet occupies exactly one LLQ entry: the optional meta
+ * descriptor, the Tx descriptor and the pushed header. The entry is built
+ * directly in the local buffer and written to the device with vector stores,
+ * bypassing the per packet ena_com_tx_ctx setup and the bounce buffer
+ * handling of the ena_com_prepare_tx(). The doorbell is written once per
+ * burst, unless the device limits the number of entries in a single Tx burst.
+ *
+ * If a multi-segment mbuf is found, the rest of the burst is handled by the
+ * scalar path.
+ */
+uint16_t ena_xmit_pkts_simple(void *tx_queue, struct rte_mbuf **tx_pkts,
+			      uint16_t nb_pkts)
+{
+	struct ena_ring *tx_ring = (struct ena_ring *)(tx_queue);
+	struct ena_com_io_sq *io_sq = tx_ring->ena_com_io_sq;
+	struct ena_com_llq_info *llq_info = &io_sq->llq_info;
+	alignas(16) uint8_t line[ENA_TX_SIMPLE_MAX_ENTRY_SIZE];
+	const uint64_t addr_hi_mask = GENMASK_ULL(io_sq->dma_addr_bits - 1, 32);
+	const uint16_t entry_size = llq_info->desc_list_entry_size;
+	const uint16_t header_offset =
+		llq_info->descs_num_before_header * io_sq->desc_entry_size;
+	const bool have_meta = tx_ring->disable_meta_caching;
+	const bool max_burst = llq_info->max_entries_in_tx_burst > 0;
+	uint16_t next_to_use = tx_ring->next_to_use;
+	struct ena_tx_buffer *tx_info;
+	struct rte_mbuf *mbuf;
+	uint32_t len_ctrl, phase;
+	uint16_t req_id, push_len, buf_len, desc_offset;
+	uint64_t paddr, timestamp, bytes = 0;
+	int available_desc, reserved;
+	uint16_t sent_idx;
+
+#ifdef RTE_ETHDEV_DEBUG_TX
+	/* Check adapter state */
+	if (unlikely(tx_ring->adapter->state != ENA_ADAPTER_STATE_RUNNING)) {
+		PMD_TX_LOG_LINE(ALERT,
+			"Trying to xmit pkts while device is NOT running");
+		return 0;
+	}
+#endif
+
+	available_desc = ena_com_free_q_entries(io_sq);
+	if (available_desc < tx_ring->tx_free_thresh) {
+		ena_tx_cleanup((void *)tx_ring, 0);
+		available_desc = ena_com_free_q_entries(io_sq);
+	}
+
+	reserved = ENA_TX_SIMPLE_DESCS_RESERVED / llq_info->descs_per_entry + 2;
+	nb_pkts = RTE_MIN(nb_pkts, RTE_MAX(available_desc - reserved, 0));
+
+	desc_offset = have_meta ? sizeof(struct ena_eth_io_tx_meta_desc) : 0;
+	timestamp = rte_get_timer_cycles();
+
+	for (sent_idx = 0; sent_idx < nb_pkts; sent_idx++) {
+		mbuf = tx_pkts[sent_idx];
+		if (unlikely(mbuf->nb_segs != 1))
+			break;
+
+		if (max_burst && unlikely(io_sq->entries_in_tx_burst_left == 0)) {
+			PMD_TX_LOG_LINE(DEBUG,
+				"LLQ Tx max burst size of queue %d achieved, writing doorbell to send burst",
+				tx_ring->id);
+			ena_com_write_sq_doorbell(io_sq);
+			tx_ring->tx_stats.doorbells++;
+		}
+
+		req_id = tx_ring->empty_tx_reqs[next_to_use];
+		tx_info = &tx_ring->tx_buffer_info[req_id];
+		RTE_ASSERT(tx_info->mbuf == NULL);
+
+		push_len = RTE_MIN(mbuf->pkt_len, tx_ring->tx_max_header_size);
+		buf_len = mbuf->data_len - push_len;
+		paddr = buf_len ? rte_mbuf_data_iova(mbuf) + push_len : 0;
+		phase = (uint32_t)io_sq->phase << ENA_ETH_IO_TX_DESC_PHASE_SHIFT;
+
+		/* Zero the descriptors area, the header tail and the padding */
+		memset(line, 0, entry_size);
+
+		if (have_meta)
+			ena_tx_simple_store16(line,
+				ENA_TX_SIMPLE_META_LEN_CTRL | phase, 0, 0, 0);
+
+		len_ctrl = (buf_len & ENA_ETH_IO_TX_DESC_LENGTH_MASK) |
+			phase |
+			ENA_ETH_IO_TX_DESC_COMP_REQ_MASK |
+			ENA_ETH_IO_TX_DESC_LAST_MASK |
+			ENA_FIELD_PREP((uint32_t)(req_id >> 10),
+				       ENA_ETH_IO_TX_DESC_REQ_ID_HI_MASK,
+				       ENA_ETH_IO_TX_DESC_REQ_ID_HI_SHIFT);
+		if (!have_meta)
+			len_ctrl |= ENA_ETH_IO_TX_DESC_FIRST_MASK;
+
+		ena_tx_simple_store16(line + desc_offset,
+			len_ctrl,
+			ENA_FIELD_PREP((uint32_t)req_id,
+				       ENA_ETH_IO_TX_DESC_REQ_ID_LO_MASK,
+				       ENA_ETH_IO_TX_DESC_REQ_ID_LO_SHIFT),
+			(uint32_t)paddr,
+			ENA_FIELD_PREP((uint32_t)push_len,
+				       ENA_ETH_IO_TX_DESC_HEADER_LENGTH_MASK,
+				       ENA_ETH_IO_TX_DESC_HEADER_LENGTH_SHIFT) |
+			(((paddr & addr_hi_mask) >> 32) &
+			 ENA_ETH_IO_TX_DESC_ADDR_HI_MASK));
+
+		rte_memcpy(line + header_offset,
+			   rte_pktmbuf_mtod(mbuf, void *), push_len);
+
+		ena_tx_simple_copy_line(io_sq->desc_addr.pbuf_dev_addr +
+			(io_sq->tail & (io_sq->q_depth - 1)) * entry_size,
+			line, entry_size);
+
+		io_sq->tail++;
+		/* Switch phase bit in case of wrap around */
+		if (unlikely((io_sq->tail & (io_sq->q_depth - 1)) == 0))
+			io_sq->phase ^= 1;
+		if (max_burst)
+			io_sq->entries_in_tx_burst_left--;
+
+		tx_info->mbuf = mbuf;
+		tx_info->num_of_bufs = buf_len ? 1 : 0;
+		tx_info->tx_descs = 1;
+		tx_info->timestamp = timestamp;
+
+		bytes += mbuf->pkt_len;
+		next_to_use = ENA_IDX_NEXT_MASKED(next_to_use, tx_ring->size_mask);
+	}
+
+	tx_ring->next_to_use = next_to_use;
+	tx_ring->tx_stats.cnt += sent_idx;
+	tx_ring->tx_stats.bytes += bytes;
+
+	if (unlikely(sent_idx < nb_pkts)) {
+		/* Let the scalar path write the doorbell for both parts */
+		if (sent_idx > 0)
+			tx_ring->pkts_without_db = true;
+		return sent_idx + eth_ena_xmit_pkts(tx_queue,
+						    tx_pkts + sent_idx,
+						    nb_pkts - sent_idx);
+	}
+
+	if (likely(sent_idx > 0)) {
+		ena_com_write_sq_doorbell(io_sq);
+		tx_ring->tx_stats.doorbells++;
+	}
+
+	tx_ring->tx_stats.available_desc = ena_com_free_q_entries(io_sq);
+	tx_ring->tx_stats.tx_poll++;
+
+	return sent_idx;
+}